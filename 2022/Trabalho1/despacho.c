@@ -0,0 +1,1156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+/** @brief Size of the output buffer, flushed whenever full */
+#define OUT_SIZE ((size_t)1 << 20)
+/** @brief Size of each read when the input can't be mapped */
+#define IN_CHUNK ((size_t)1 << 20)
+/** @brief Room for any single number formatted by out_*() */
+#define NUM_MAX 64
+
+/** @brief Milliseconds elapsed between two `struct timeval` */
+#define ELAPSED_MS(t1, t2)                                                    \
+    (((t2).tv_sec - (t1).tv_sec) * 1000.0                                     \
+     + ((t2).tv_usec - (t1).tv_usec) / 1000.0)
+
+/** @brief Whether `c` separates fields (`FS` at despacho.awk) */
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\n')
+
+/** @brief Instance text, mapped or read whole */
+struct input {
+    /** first byte */
+    const char *data;
+    /** one past the last byte */
+    const char *end;
+    /** mapped file, or `NULL` if read into `buf` */
+    void *map;
+    /** size of `map` */
+    size_t map_size;
+    /** buffer with the input read from a pipe, or `NULL` if mapped */
+    char *buf;
+};
+
+/** @brief Buffered writer to a file */
+struct output {
+    /** file written */
+    FILE *fp;
+    /** bytes not yet written */
+    char buf[OUT_SIZE];
+    /** amount of bytes at `buf` */
+    size_t len;
+    /** whether a write failed */
+    bool error;
+};
+
+/** @brief Instance data, other than the monthly series */
+struct instance {
+    /** amount of months */
+    unsigned long n;
+    /** hydroelectric volumes (initial, minimum, maximum) */
+    double V[3];
+    /** generation coefficient */
+    double k;
+    /** thermoelectric maximum generation */
+    double tmax;
+    /** thermoelectric generation cost */
+    double CT;
+    /** environmental cost of the reservoir variation */
+    double CA;
+};
+
+/**
+ * @brief Map the instance file or, for pipes, read it whole
+ *
+ * @param in stores the instance text
+ * @param fd file descriptor to be read
+ * @return a boolean for success
+ */
+static bool
+input_open(struct input *in, int fd)
+{
+    struct stat st;
+    size_t len = 0, size = IN_CHUNK;
+    ssize_t nread;
+
+    *in = (struct input){ 0 };
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                         fd, 0);
+
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            in->map = map;
+            in->map_size = (size_t)st.st_size;
+            in->data = map;
+            in->end = in->data + in->map_size;
+            return true;
+        }
+    }
+
+    if (!(in->buf = malloc(size))) {
+        perror("malloc()");
+        return false;
+    }
+    while ((nread = read(fd, in->buf + len, size - len)) != 0) {
+        if (nread < 0) {
+            perror("read()");
+            return false;
+        }
+        len += (size_t)nread;
+        if (len == size) {
+            char *tmp = realloc(in->buf, size *= 2);
+
+            if (!tmp) {
+                perror("realloc()");
+                return false;
+            }
+            in->buf = tmp;
+        }
+    }
+    in->data = in->buf;
+    in->end = in->buf + len;
+    return true;
+}
+
+/**
+ * @brief Cleanup the resources allocated for @ref input
+ *
+ * @param in instance text opened with input_open()
+ */
+static void
+input_close(struct input *in)
+{
+    if (in->map) munmap(in->map, in->map_size);
+    free(in->buf);
+}
+
+/**
+ * @brief Skip to the next field
+ *
+ * @param cur current position, updated to the start of the next field
+ * @param end one past the last byte
+ * @return `true` if there's a field left
+ */
+static bool
+field_next(const char **cur, const char *end)
+{
+    while (*cur < end && IS_SPACE(**cur))
+        ++*cur;
+    return *cur < end;
+}
+
+/**
+ * @brief Read the next field as a number
+ *
+ * @param cur current position, updated past the field read
+ * @param end one past the last byte
+ * @param value stores the number read
+ * @return `true` if a number was read
+ */
+static bool
+field_number(const char **cur, const char *end, double *value)
+{
+    char tmp[NUM_MAX], *tail;
+    size_t len = 0;
+
+    if (!field_next(cur, end)) return false;
+    while (*cur + len < end && !IS_SPACE((*cur)[len]))
+        ++len;
+    if (len >= NUM_MAX) return false;
+    /* fields aren't null terminated, so copy one before converting it */
+    memcpy(tmp, *cur, len);
+    tmp[len] = '\0';
+    *value = strtod(tmp, &tail);
+    *cur += len;
+    return tail != tmp;
+}
+
+/**
+ * @brief Read the next field as a count
+ *
+ * @param cur current position, updated past the field read
+ * @param end one past the last byte
+ * @param max largest count accepted
+ * @param count stores the count read
+ * @return `true` if a non-negative integer up to `max` was read
+ */
+static bool
+field_count(const char **cur,
+            const char *end,
+            unsigned long max,
+            unsigned long *count)
+{
+    /* first value past every unsigned long, so the cast below is defined */
+    const double limit = ldexp(1, CHAR_BIT * sizeof(unsigned long));
+    double value;
+
+    if (!field_number(cur, end, &value) || !(value >= 0 && value < limit)
+        || value != floor(value) || (unsigned long)value > max)
+    {
+        return false;
+    }
+    *count = (unsigned long)value;
+    return true;
+}
+
+/**
+ * @brief Skip `count` fields
+ *
+ * @param cur current position, updated past the fields skipped
+ * @param end one past the last byte
+ * @param count amount of fields to be skipped
+ * @return `true` if there were `count` fields
+ */
+static bool
+field_skip(const char **cur, const char *end, unsigned long count)
+{
+    for (unsigned long i = 0; i < count; ++i) {
+        if (!field_next(cur, end)) return false;
+        while (*cur < end && !IS_SPACE(**cur))
+            ++*cur;
+    }
+    return true;
+}
+
+/**
+ * @brief Write whatever is buffered
+ *
+ * @param out buffered writer
+ */
+static void
+out_flush(struct output *out)
+{
+    if (out->len && fwrite(out->buf, 1, out->len, out->fp) != out->len)
+        out->error = true;
+    out->len = 0;
+}
+
+/**
+ * @brief Append `len` bytes
+ *
+ * @param out buffered writer
+ * @param s bytes to be appended
+ * @param len amount of bytes
+ */
+static void
+out_bytes(struct output *out, const char *s, size_t len)
+{
+    if (OUT_SIZE - out->len < len) out_flush(out);
+    memcpy(out->buf + out->len, s, len);
+    out->len += len;
+}
+
+/** @brief Append a string literal */
+#define OUT_STR(out, s) out_bytes(out, s, sizeof(s) - 1)
+
+/**
+ * @brief Append an unsigned integer in decimal
+ *
+ * @param out buffered writer
+ * @param v integer to be appended
+ */
+static void
+out_ulong(struct output *out, unsigned long v)
+{
+    char tmp[NUM_MAX], *p = tmp + sizeof tmp;
+
+    do {
+        *--p = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    out_bytes(out, p, (size_t)(tmp + sizeof tmp - p));
+}
+
+/**
+ * @brief Append a number the way awk's `%d` does, truncated to an integer
+ *
+ * @param out buffered writer
+ * @param v number to be appended
+ */
+static void
+out_int(struct output *out, double v)
+{
+    char tmp[NUM_MAX];
+    int len;
+
+    v = trunc(v) + 0.0; // no "-0"
+    if (fabs(v) < 1e15) {
+        if (v < 0) OUT_STR(out, "-");
+        out_ulong(out, (unsigned long)fabs(v));
+        return;
+    }
+    len = snprintf(tmp, sizeof tmp, "%.0f", v);
+    out_bytes(out, tmp, (size_t)len);
+}
+
+/**
+ * @brief Append a number the way awk's `%g` does
+ *
+ * @param out buffered writer
+ * @param v number to be appended
+ */
+static void
+out_g(struct output *out, double v)
+{
+    char tmp[NUM_MAX];
+    const int len = snprintf(tmp, sizeof tmp, "%g", v);
+
+    out_bytes(out, tmp, (size_t)len);
+}
+
+/**
+ * @brief Write the lp_solve model, term by term as despacho.awk does
+ *
+ * @param out buffered writer
+ * @param inst instance data
+ * @param D first monthly demand
+ * @param D_end one past the last byte of the demands text
+ * @param Y first monthly inflow
+ * @param Y_end one past the last byte of the inflows text
+ * @return a boolean for success
+ */
+static bool
+model_write(struct output *out,
+            const struct instance *inst,
+            const char *D,
+            const char *D_end,
+            const char *Y,
+            const char *Y_end)
+{
+    const unsigned long n = inst->n;
+    char k[NUM_MAX];
+    const int k_len = snprintf(k, sizeof k, "%g", inst->k);
+
+    /* objective function to be minimized */
+    OUT_STR(out, "min: ");
+    out_g(out, inst->CT);
+    OUT_STR(out, " t + ");
+    out_g(out, inst->CA);
+    OUT_STR(out, " a;\n\n");
+
+    /* variables used at the objective function */
+    OUT_STR(out, "t = ");
+    for (unsigned long i = 1; i < n; ++i) {
+        OUT_STR(out, "custoT");
+        out_ulong(out, i);
+        OUT_STR(out, " + ");
+    }
+    OUT_STR(out, "custoT");
+    out_ulong(out, n);
+    OUT_STR(out, ";\na = ");
+    for (unsigned long i = 1; i < n; ++i) {
+        OUT_STR(out, "var");
+        out_ulong(out, i);
+        OUT_STR(out, " + ");
+    }
+    OUT_STR(out, "var");
+    out_ulong(out, n);
+    OUT_STR(out, ";\n");
+    /* first reservoir volume */
+    OUT_STR(out, "r0 = ");
+    out_int(out, inst->V[0]);
+    OUT_STR(out, ";\n\n");
+
+    /* monthly restrictions, reading demands and inflows side by side */
+    for (unsigned long i = 1; i <= n; ++i) {
+        double d, y;
+
+        if (!field_number(&D, D_end, &d) || !field_number(&Y, Y_end, &y)) {
+            fprintf(stderr, "Invalid demand or inflow for month %lu\n", i);
+            return false;
+        }
+        OUT_STR(out, "custoT");
+        out_ulong(out, i);
+        OUT_STR(out, " + ");
+        out_bytes(out, k, (size_t)k_len);
+        OUT_STR(out, " total");
+        out_ulong(out, i);
+        OUT_STR(out, " >= ");
+        out_int(out, d);
+        OUT_STR(out, ";\n");
+
+        OUT_STR(out, "var");
+        out_ulong(out, i);
+        OUT_STR(out, " >= ");
+        out_int(out, y);
+        OUT_STR(out, " - total");
+        out_ulong(out, i);
+        OUT_STR(out, ";\n");
+
+        OUT_STR(out, "var");
+        out_ulong(out, i);
+        OUT_STR(out, " >= -");
+        out_int(out, y);
+        OUT_STR(out, " + total");
+        out_ulong(out, i);
+        OUT_STR(out, ";\n");
+
+        OUT_STR(out, "r");
+        out_ulong(out, i);
+        OUT_STR(out, " = r");
+        out_ulong(out, i - 1);
+        OUT_STR(out, " + ");
+        out_int(out, y);
+        OUT_STR(out, " - total");
+        out_ulong(out, i);
+        OUT_STR(out, ";\n");
+
+        out_int(out, inst->V[1]);
+        OUT_STR(out, " <= r");
+        out_ulong(out, i);
+        OUT_STR(out, " <= ");
+        out_int(out, inst->V[2]);
+        OUT_STR(out, ";\n");
+
+        OUT_STR(out, "0 <= custoT");
+        out_ulong(out, i);
+        OUT_STR(out, " <= ");
+        out_int(out, inst->tmax);
+        OUT_STR(out, ";\n");
+
+        OUT_STR(out, "var");
+        out_ulong(out, i);
+        OUT_STR(out, " >= 0;\n\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Slopes of the monthly cost, as a function of how much the
+ *      reservoir rose in the month
+ * @note every month's cost (and so the optimal cost of reaching each volume)
+ *      is convex and piecewise linear over these same four slopes, so a
+ *      function is kept as the length of each slope's piece
+ */
+enum slope {
+    /** reservoir falling, thermoelectric idle (`-CA`) */
+    SLOPE_FALL,
+    /** reservoir falling, thermoelectric covering the demand (`CT k - CA`) */
+    SLOPE_FALL_THERMAL,
+    /** reservoir rising, thermoelectric idle (`CA`) */
+    SLOPE_RISE,
+    /** reservoir rising, thermoelectric covering the demand (`CT k + CA`) */
+    SLOPE_RISE_THERMAL,
+    /** amount of slopes */
+    SLOPE_MAX
+};
+
+/** @brief Slope values, along with their ascending order */
+struct slopes {
+    /** value of each @ref slope */
+    double value[SLOPE_MAX];
+    /** slopes from the smallest value to the largest */
+    enum slope order[SLOPE_MAX];
+};
+
+/**
+ * @brief Convex piecewise linear function over a volume (or a volume
+ *      change), anchored at the right end of its domain
+ */
+struct pwl {
+    /** right end of the domain */
+    double hi;
+    /** value at `hi` */
+    double value;
+    /** length of each slope's piece (`INFINITY` if unbounded to the left) */
+    double len[SLOPE_MAX];
+};
+
+/**
+ * @brief Compute the slopes and their order, which only depend on the
+ *      instance costs
+ *
+ * @param sl stores the slopes
+ * @param inst instance data
+ */
+static void
+slopes_init(struct slopes *sl, const struct instance *inst)
+{
+    const double thermal = inst->CT * inst->k;
+    const bool fall_thermal_first = thermal - inst->CA <= inst->CA;
+
+    sl->value[SLOPE_FALL] = -inst->CA;
+    sl->value[SLOPE_FALL_THERMAL] = thermal - inst->CA;
+    sl->value[SLOPE_RISE] = inst->CA;
+    sl->value[SLOPE_RISE_THERMAL] = thermal + inst->CA;
+    sl->order[0] = SLOPE_FALL;
+    sl->order[1] = fall_thermal_first ? SLOPE_FALL_THERMAL : SLOPE_RISE;
+    sl->order[2] = fall_thermal_first ? SLOPE_RISE : SLOPE_FALL_THERMAL;
+    sl->order[3] = SLOPE_RISE_THERMAL;
+}
+
+/**
+ * @brief Cost of a month as a function of the reservoir rise `y = Y - total`
+ *      (`CA |y|` plus `CT` per unit of demand the hydroelectric leaves out)
+ *
+ * @param h stores the month cost
+ * @param inst instance data
+ * @param d month demand
+ * @param y month inflow
+ * @return `false` if the thermoelectric can't cover the demand left
+ */
+static bool
+month_cost(struct pwl *h, const struct instance *inst, double d, double y)
+{
+    /* least generation so that the thermoelectric covers the rest */
+    const double total_min =
+        inst->k > 0 ? fmax(0, (d - inst->tmax) / inst->k) : 0;
+    /* rise past which the thermoelectric is needed */
+    const double thermal_at = inst->k > 0 ? y - d / inst->k : INFINITY;
+
+    if (inst->k <= 0 && d > inst->tmax) return false;
+    h->hi = y - total_min;
+    h->value = inst->CA * fabs(h->hi)
+               + inst->CT * fmax(0, d - inst->k * total_min);
+    /* from the left: falling with the thermoelectric idle (unbounded),
+     *      falling with it needed, rising idle and rising with it needed */
+    h->len[SLOPE_FALL] = INFINITY;
+    h->len[SLOPE_FALL_THERMAL] =
+        thermal_at < 0 ? fmax(0, fmin(0, h->hi) - thermal_at) : 0;
+    h->len[SLOPE_RISE] =
+        thermal_at > 0 ? fmax(0, fmin(thermal_at, h->hi)) : 0;
+    h->len[SLOPE_RISE_THERMAL] = fmax(0, h->hi - fmax(0, thermal_at));
+    return true;
+}
+
+/**
+ * @brief Advance the optimal cost of each volume by one month: every volume
+ *      `s` reached so far may rise by any `y` of the month cost, then the
+ *      result is restricted to the volume bounds
+ * @note the (infimal) convolution of convex piecewise linear functions just
+ *      merges their pieces by slope
+ *
+ * @param f optimal cost of each volume, updated
+ * @param h month cost
+ * @param sl slopes
+ * @param lo minimum volume
+ * @param hi maximum volume
+ * @return `false` if no volume within the bounds can be reached
+ */
+static bool
+pwl_step(struct pwl *f,
+         const struct pwl *h,
+         const struct slopes *sl,
+         double lo,
+         double hi)
+{
+    double cut, room;
+
+    f->hi += h->hi;
+    f->value += h->value;
+    for (int j = 0; j < SLOPE_MAX; ++j)
+        f->len[j] += h->len[j];
+
+    /* drop volumes past the maximum, from the steepest piece down */
+    cut = f->hi - hi;
+    for (int j = SLOPE_MAX - 1; j >= 0 && cut > 0; --j) {
+        const enum slope o = sl->order[j];
+        const double t = fmin(cut, f->len[o]);
+
+        f->value -= sl->value[o] * t;
+        f->len[o] -= t;
+        f->hi -= t;
+        cut -= t;
+    }
+    if (cut > 0) return false;
+
+    /* drop volumes below the minimum, keeping the pieces closest to hi */
+    if ((room = f->hi - lo) < 0) return false;
+    for (int j = SLOPE_MAX - 1; j >= 0; --j) {
+        const enum slope o = sl->order[j];
+
+        f->len[o] = fmin(f->len[o], room);
+        room -= f->len[o];
+    }
+    return true;
+}
+
+/**
+ * @brief Append a variable and its value, laid out as lp_solve does
+ *
+ * @param out buffered writer
+ * @param prefix variable name
+ * @param i variable index (`ULONG_MAX` for none)
+ * @param value variable value
+ */
+static void
+out_variable(struct output *out,
+             const char *prefix,
+             unsigned long i,
+             double value)
+{
+    char name[NUM_MAX], tmp[2 * NUM_MAX];
+    int len;
+
+    if (i == ULONG_MAX)
+        snprintf(name, sizeof name, "%s", prefix);
+    else
+        snprintf(name, sizeof name, "%s%lu", prefix, i);
+    len = snprintf(tmp, sizeof tmp, "%-20s %12g\n", name, value + 0.0);
+    out_bytes(out, tmp, (size_t)len);
+}
+
+/** @brief Buffers for dispatch_solve(), one set per thread */
+struct workspace {
+    /** optimal cost of each volume before each month */
+    struct pwl *trail;
+    /** monthly inflows */
+    double *y;
+    /** monthly volumes (`r0` included) traced back */
+    double *r;
+};
+
+/**
+ * @brief Allocate the buffers for a horizon of `n` months
+ *
+ * @param ws buffers to be initialized
+ * @param n amount of months
+ * @return a boolean for success, either way a workspace_cleanup() should be
+ *      called
+ */
+static bool
+workspace_init(struct workspace *ws, unsigned long n)
+{
+    *ws = (struct workspace){
+        .trail = calloc(n + 1, sizeof *ws->trail),
+        .y = calloc(n + 1, sizeof *ws->y),
+        .r = calloc(n + 1, sizeof *ws->r),
+    };
+    if (!ws->trail || !ws->y || !ws->r) {
+        perror("calloc()");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Cleanup the resources allocated for @ref workspace
+ *
+ * @param ws buffers initialized with workspace_init()
+ */
+static void
+workspace_cleanup(struct workspace *ws)
+{
+    free(ws->trail);
+    free(ws->y);
+    free(ws->r);
+}
+
+/**
+ * @brief Whether dispatch_solve() applies, as it relies on a convex monthly
+ *      cost
+ *
+ * @param inst instance data
+ * @return `true` if the coefficient and the costs aren't negative
+ */
+static bool
+dispatch_supported(const struct instance *inst)
+{
+    if (inst->k < 0 || inst->CT < 0 || inst->CA < 0) {
+        fputs("Negative coefficient or costs aren't supported\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Solve the dispatch directly: the optimal cost of each reservoir
+ *      volume is carried month by month, then the volumes are traced back
+ *      from the cheapest final one
+ *
+ * @param inst instance data
+ * @param sl slopes initialized with slopes_init()
+ * @param d monthly demands
+ * @param ws buffers with the monthly inflows, stores the volumes at `r`
+ * @param cost_T stores the thermoelectric generation (`t`)
+ * @param cost_A stores the reservoir variation (`a`)
+ * @return `false` if the instance is infeasible
+ */
+static bool
+dispatch_solve(const struct instance *inst,
+               const struct slopes *sl,
+               const double d[],
+               struct workspace *ws,
+               double *cost_T,
+               double *cost_A)
+{
+    const unsigned long n = inst->n;
+    const double *y = ws->y;
+    double *r = ws->r;
+    struct pwl f = { .hi = inst->V[0] }, h;
+
+    for (unsigned long i = 0; i < n; ++i) {
+        ws->trail[i] = f;
+        if (!month_cost(&h, inst, d[i], y[i])
+            || !pwl_step(&f, &h, sl, inst->V[1], inst->V[2]))
+            return false;
+    }
+
+    /* cheapest final volume, where the slope turns non-negative */
+    r[n] = f.hi;
+    for (int j = SLOPE_MAX - 1; j >= 0; --j)
+        if (sl->value[sl->order[j]] > 0) r[n] -= f.len[sl->order[j]];
+    /* trace back each month's rise, splitting pieces of equal slope
+     *      between the previous volume and the month cost in any way */
+    for (unsigned long i = n; i-- > 0;) {
+        const struct pwl *prev = &ws->trail[i];
+        double left, taken = 0;
+
+        month_cost(&h, inst, d[i], y[i]);
+        left = prev->hi + h.hi - r[i + 1];
+        for (int j = SLOPE_MAX - 1; j >= 0 && left > 0; --j) {
+            const enum slope o = sl->order[j];
+            const double t = fmin(left, prev->len[o]);
+
+            taken += t;
+            left -= t + fmin(left - t, h.len[o]);
+        }
+        r[i] = prev->hi - taken;
+    }
+
+    *cost_T = *cost_A = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        const double total = r[i] + y[i] - r[i + 1];
+
+        *cost_T += fmax(0, d[i] - inst->k * total);
+        *cost_A += fabs(y[i] - total);
+    }
+    return true;
+}
+
+/**
+ * @brief Solve the dispatch with dispatch_solve() and write the solution
+ *
+ * @param out buffered writer
+ * @param inst instance data
+ * @param D first monthly demand
+ * @param Y first monthly inflow
+ * @param end one past the last byte of the instance text
+ * @return a boolean for success
+ */
+static bool
+model_solve(struct output *out,
+            const struct instance *inst,
+            const char *D,
+            const char *Y,
+            const char *end)
+{
+    const unsigned long n = inst->n;
+    double *d = calloc(n + 1, sizeof *d), *y, *r;
+    struct workspace ws;
+    struct slopes sl;
+    double cost_T, cost_A;
+    char tmp[2 * NUM_MAX];
+    bool ok = false;
+
+    if (!workspace_init(&ws, n) || !d) {
+        if (!d) perror("calloc()");
+        goto _cleanup;
+    }
+    if (!dispatch_supported(inst)) goto _cleanup;
+    y = ws.y;
+    r = ws.r;
+    for (unsigned long i = 0; i < n; ++i)
+        if (!field_number(&D, end, &d[i]) || !field_number(&Y, end, &y[i]))
+        {
+            fprintf(stderr, "Invalid demand or inflow for month %lu\n",
+                    i + 1);
+            goto _cleanup;
+        }
+
+    slopes_init(&sl, inst);
+    if (!dispatch_solve(inst, &sl, d, &ws, &cost_T, &cost_A)) {
+        OUT_STR(out, "\nThis problem is infeasible\n");
+        ok = true;
+        goto _cleanup;
+    }
+    out_bytes(out, tmp,
+              (size_t)snprintf(tmp, sizeof tmp,
+                               "\nValue of objective function: %.8f\n",
+                               inst->CT * cost_T + inst->CA * cost_A + 0.0));
+    OUT_STR(out, "\nActual values of the variables:\n");
+    out_variable(out, "t", ULONG_MAX, cost_T);
+    out_variable(out, "a", ULONG_MAX, cost_A);
+    for (unsigned long i = 0; i < n; ++i)
+        out_variable(out, "custoT", i + 1,
+                     fmax(0, d[i] - inst->k * (r[i] + y[i] - r[i + 1])));
+    for (unsigned long i = 0; i < n; ++i)
+        out_variable(out, "var", i + 1, fabs(r[i] - r[i + 1]));
+    out_variable(out, "r", 0, r[0]);
+    for (unsigned long i = 0; i < n; ++i) {
+        out_variable(out, "total", i + 1, r[i] + y[i] - r[i + 1]);
+        out_variable(out, "r", i + 1, r[i + 1]);
+    }
+    ok = true;
+
+_cleanup:
+    workspace_cleanup(&ws);
+    free(d);
+    return ok;
+}
+
+/** @brief Scenarios shared among batch_worker() threads */
+struct batch {
+    /** instance data */
+    const struct instance *inst;
+    /** slopes initialized with slopes_init() */
+    const struct slopes *sl;
+    /** monthly demands */
+    const double *d;
+    /** first monthly demand at the instance text */
+    const char *D;
+    /** one past the last byte of the instance text */
+    const char *D_end;
+    /** first monthly inflow of each scenario at the scenarios text */
+    const char **Y;
+    /** one past the last byte of the scenarios text */
+    const char *Y_end;
+    /** amount of scenarios */
+    size_t S;
+    /** models are written to `<prefix><scenario>.lp` (`NULL` for none) */
+    const char *prefix;
+    /** next scenario to be taken */
+    _Atomic size_t next;
+    /** optimal cost of each scenario (`NAN` if infeasible) */
+    double *cost;
+    /** whether some scenario couldn't be read or written */
+    _Atomic bool failed;
+};
+
+/**
+ * @brief Write the model of scenario `k` to its own file
+ *
+ * @param b scenarios
+ * @param out buffered writer
+ * @param k scenario
+ * @return a boolean for success
+ */
+static bool
+batch_model(const struct batch *b, struct output *out, size_t k)
+{
+    char path[4096];
+    bool ok;
+
+    snprintf(path, sizeof path, "%s%zu.lp", b->prefix, k + 1);
+    if (!(out->fp = fopen(path, "w"))) {
+        perror(path);
+        return false;
+    }
+    out->len = 0;
+    out->error = false;
+    ok = model_write(out, b->inst, b->D, b->D_end, b->Y[k], b->Y_end);
+    out_flush(out);
+    if (out->error) perror(path);
+    if (fclose(out->fp) != 0) {
+        perror(path);
+        ok = false;
+    }
+    return ok && !out->error;
+}
+
+/**
+ * @brief Take scenarios until every one is solved
+ *
+ * @param arg shared @ref batch
+ * @return `NULL`
+ */
+static void *
+batch_worker(void *arg)
+{
+    struct batch *b = arg;
+    struct output *out = NULL;
+    struct workspace ws;
+
+    if (!workspace_init(&ws, b->inst->n)
+        || (b->prefix && !(out = malloc(sizeof *out))))
+    {
+        if (b->prefix && !out) perror("malloc()");
+        atomic_store(&b->failed, true);
+    }
+    while (!atomic_load(&b->failed)) {
+        const size_t k = atomic_fetch_add(&b->next, 1);
+        const char *Y;
+        double cost_T, cost_A;
+        bool ok = true;
+
+        if (k >= b->S) break;
+        Y = b->Y[k];
+        for (unsigned long i = 0; i < b->inst->n && ok; ++i)
+            if (!(ok = field_number(&Y, b->Y_end, &ws.y[i])))
+                fprintf(stderr, "Invalid inflow for month %lu of scenario "
+                                "%zu\n",
+                        i + 1, k + 1);
+        if (ok && b->prefix) ok = batch_model(b, out, k);
+        if (!ok) {
+            atomic_store(&b->failed, true);
+            break;
+        }
+        b->cost[k] = dispatch_solve(b->inst, b->sl, b->d, &ws, &cost_T,
+                                    &cost_A)
+                         ? b->inst->CT * cost_T + b->inst->CA * cost_A
+                         : NAN;
+    }
+    workspace_cleanup(&ws);
+    free(out);
+    return NULL;
+}
+
+/** @brief Sort costs in ascending order */
+static int
+cost_cmp(const void *p_a, const void *p_b)
+{
+    const double a = *(const double *)p_a, b = *(const double *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Solve the instance for every scenario of monthly inflows in
+ *      parallel, writing one row per scenario and the costs statistics
+ * @note scenarios are read as an amount `S` followed by `S` rows of `n`
+ *      inflows, which replace the instance's own
+ *
+ * @param out buffered writer
+ * @param inst instance data
+ * @param D first monthly demand
+ * @param end one past the last byte of the instance text
+ * @param scenarios scenarios text
+ * @param threads amount of worker threads
+ * @param prefix models are written to `<prefix><scenario>.lp` (`NULL` for
+ *      none)
+ * @return a boolean for success
+ */
+static bool
+batch_solve(struct output *out,
+            const struct instance *inst,
+            const char *D,
+            const char *end,
+            const struct input *scenarios,
+            size_t threads,
+            const char *prefix)
+{
+    struct batch b = { .inst = inst,
+                       .D = D,
+                       .D_end = end,
+                       .Y_end = scenarios->end,
+                       .prefix = prefix };
+    const char *cur = scenarios->data;
+    double *d = calloc(inst->n + 1, sizeof *d), *sorted = NULL, sum = 0;
+    pthread_t *tids = calloc(threads, sizeof *tids);
+    struct timeval t1, t2;
+    struct slopes sl;
+    size_t feasible = 0, started = 0;
+    unsigned long S;
+    char tmp[2 * NUM_MAX];
+    bool ok = false;
+
+    if (!d || !tids) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    if (!dispatch_supported(inst)) goto _cleanup;
+    for (unsigned long i = 0; i < inst->n; ++i)
+        if (!field_number(&D, end, &d[i])) {
+            fprintf(stderr, "Invalid demand for month %lu\n", i + 1);
+            goto _cleanup;
+        }
+    /* one less than SIZE_MAX, so the arrays below have room for S + 1 */
+    if (!field_count(&cur, scenarios->end, SIZE_MAX - 1, &S)) {
+        fputs("Invalid amount of scenarios\n", stderr);
+        goto _cleanup;
+    }
+    b.S = S;
+    b.Y = calloc(b.S + 1, sizeof *b.Y);
+    b.cost = calloc(b.S + 1, sizeof *b.cost);
+    sorted = calloc(b.S + 1, sizeof *sorted);
+    if (!b.Y || !b.cost || !sorted) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    /* only the start of each scenario is kept, workers read the rest */
+    for (size_t k = 0; k < b.S; ++k) {
+        b.Y[k] = cur;
+        if (!field_skip(&cur, scenarios->end, inst->n)) {
+            fprintf(stderr, "Missing inflows for scenario %zu\n", k + 1);
+            goto _cleanup;
+        }
+    }
+    if (field_next(&cur, scenarios->end)) {
+        fputs("Unexpected data after the last scenario\n", stderr);
+        goto _cleanup;
+    }
+    slopes_init(&sl, inst);
+    b.sl = &sl;
+    b.d = d;
+
+    gettimeofday(&t1, NULL);
+    for (; started < threads; ++started)
+        if (pthread_create(&tids[started], NULL, &batch_worker, &b)) {
+            perror("pthread_create()");
+            atomic_store(&b.failed, true);
+            break;
+        }
+    for (size_t j = 0; j < started; ++j)
+        pthread_join(tids[j], NULL);
+    gettimeofday(&t2, NULL);
+    if (atomic_load(&b.failed)) goto _cleanup;
+
+    for (size_t k = 0; k < b.S; ++k) {
+        if (isnan(b.cost[k])) {
+            out_bytes(out, tmp,
+                      (size_t)snprintf(tmp, sizeof tmp, "%zu infeasible\n",
+                                       k + 1));
+            continue;
+        }
+        out_bytes(out, tmp,
+                  (size_t)snprintf(tmp, sizeof tmp, "%zu %.8f\n", k + 1,
+                                   b.cost[k] + 0.0));
+        sorted[feasible++] = b.cost[k];
+        sum += b.cost[k];
+    }
+    qsort(sorted, feasible, sizeof *sorted, &cost_cmp);
+
+    fprintf(stderr, "Scenarios: %zu\nInfeasible: %zu\n", b.S,
+            b.S - feasible);
+    if (feasible) {
+        static const double q[] = { 0.05, 0.25, 0.5, 0.75, 0.95 };
+
+        fprintf(stderr, "Mean: %.8f\nMin: %.8f\n", sum / feasible,
+                sorted[0]);
+        /* nearest rank */
+        for (size_t j = 0; j < sizeof q / sizeof *q; ++j) {
+            const size_t rank = (size_t)ceil(q[j] * feasible);
+
+            fprintf(stderr, "P%02.0f: %.8f\n", 100 * q[j],
+                    sorted[rank ? rank - 1 : 0]);
+        }
+        fprintf(stderr, "Max: %.8f\n", sorted[feasible - 1]);
+    }
+    fprintf(stderr, "Elapsed time: %.17G ms\nThreads: %zu\n",
+            ELAPSED_MS(t1, t2), threads);
+    ok = true;
+
+_cleanup:
+    free(d);
+    free(tids);
+    free(b.Y);
+    free(b.cost);
+    free(sorted);
+    return ok;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static struct output out;
+    struct instance inst;
+    struct input in = { 0 }, scenarios = { 0 };
+    const char *cur, *D, *Y, *batch = NULL, *prefix = NULL;
+    long nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = nproc > 0 ? (size_t)nproc : 1;
+    int fd = STDIN_FILENO, batch_fd = -1;
+    bool solve = false, ok = false;
+
+    for (int opt; (opt = getopt(argc, argv, "sb:j:m:h")) != -1;) {
+        switch (opt) {
+        case 's':
+            solve = true;
+            break;
+        case 'b':
+            batch = optarg;
+            break;
+        case 'j':
+            threads = strtoul(optarg, NULL, 10);
+            break;
+        case 'm':
+            prefix = optarg;
+            break;
+        case 'h':
+        default:
+        _usage:
+            fprintf(stderr,
+                    "Usage ./%s [-s] [-b SCENARIOS [-j threads] "
+                    "[-m PREFIX]] [-h] [FILE]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind < argc - 1 || threads == 0 || (solve && batch)
+        || (!batch && prefix))
+    {
+        goto _usage;
+    }
+    if (optind < argc && (fd = open(argv[optind], O_RDONLY)) < 0) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    if (batch && (batch_fd = open(batch, O_RDONLY)) < 0) {
+        perror(batch);
+        goto _cleanup;
+    }
+    if (!input_open(&in, fd)
+        || (batch && !input_open(&scenarios, batch_fd)))
+    {
+        goto _cleanup;
+    }
+
+    /* the series are streamed later, only their starts are kept */
+    cur = in.data;
+    if (!field_count(&cur, in.end, ULONG_MAX, &inst.n)) {
+        fputs("Invalid amount of months\n", stderr);
+        goto _cleanup;
+    }
+    D = cur;
+    if (!field_skip(&cur, in.end, inst.n)) {
+        fputs("Missing monthly demands\n", stderr);
+        goto _cleanup;
+    }
+    Y = cur;
+    if (!field_skip(&cur, in.end, inst.n)) {
+        fputs("Missing monthly inflows\n", stderr);
+        goto _cleanup;
+    }
+    if (!field_number(&cur, in.end, &inst.V[0])
+        || !field_number(&cur, in.end, &inst.V[1])
+        || !field_number(&cur, in.end, &inst.V[2])
+        || !field_number(&cur, in.end, &inst.k)
+        || !field_number(&cur, in.end, &inst.tmax)
+        || !field_number(&cur, in.end, &inst.CT)
+        || !field_number(&cur, in.end, &inst.CA))
+    {
+        fputs("Invalid volumes, coefficient or costs\n", stderr);
+        goto _cleanup;
+    }
+
+    out.fp = stdout;
+    if (batch)
+        ok = batch_solve(&out, &inst, D, in.end, &scenarios, threads, prefix);
+    else if (solve)
+        ok = model_solve(&out, &inst, D, Y, in.end);
+    else
+        ok = model_write(&out, &inst, D, in.end, Y, in.end);
+    out_flush(&out);
+    if (out.error || fflush(stdout) != 0) {
+        perror("fwrite()");
+        ok = false;
+    }
+
+_cleanup:
+    input_close(&in);
+    input_close(&scenarios);
+    if (fd != STDIN_FILENO) close(fd);
+    if (batch_fd >= 0) close(batch_fd);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
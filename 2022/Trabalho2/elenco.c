@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
 
 #include <unistd.h>
 
@@ -8,41 +10,23 @@
 
 /* alt bounding function provided at the README.pdf */
 static unsigned
-alt_bounding_fn(
-    struct bb_actor E[], size_t Em, struct bb_actor F[], size_t Fm, size_t n)
+alt_bounding_fn(const struct bb_node *node, size_t n)
 {
-    unsigned sum_cost = 0, min_cost = F[0].c;
-    for (size_t i = 0; i < Em; ++i)
-        sum_cost += E[i].c;
-    for (size_t i = 1; i < Fm; ++i)
-        if (F[i].c < min_cost) min_cost = F[i].c;
-    return sum_cost + (n - Em) * min_cost;
+    if (node->Em > n || n - node->Em > node->Fm)
+        return UINT_MAX; // can't cast exactly n
+    if (node->Em == n) return node->E_c;
+    return node->E_c + (n - node->Em) * node->F_c[1];
 }
 
 /* default bounding function (should be slight better than alt_bounding_fn in
- *      most cases) */
+ *      most cases): cast actors plus the cheapest actors left to fill the
+ *      remaining characters */
 static unsigned
-default_bounding_fn(
-    struct bb_actor E[], size_t Em, struct bb_actor F[], size_t Fm, size_t n)
+default_bounding_fn(const struct bb_node *node, size_t n)
 {
-    const unsigned leftover = n - Em;
-    unsigned sum_cost = 0;
-    unsigned memo[512]; // keep track of smaller costs
-    size_t idx = 0;
-    for (size_t i = 0; i < Em; ++i)
-        sum_cost += E[i].c;
-    // backtrack smaller costs
-    memo[idx++] = F[0].c;
-    for (size_t i = 1; i < Fm; ++i) {
-        if (F[i].c <= memo[idx - 1]) {
-            memo[idx++] = F[i].c;
-        }
-    }
-    for (ssize_t i = idx - 1; i >= 0 && idx < leftover; --i)
-        memo[idx++] = memo[i];
-    for (size_t i = 0; i < leftover; ++i)
-        sum_cost += memo[(idx - i) - 1];
-    return sum_cost;
+    if (node->Em > n || n - node->Em > node->Fm)
+        return UINT_MAX; // can't cast exactly n
+    return node->E_c + node->F_c[n - node->Em];
 }
 
 int
@@ -51,9 +35,18 @@ main(int argc, char *argv[])
     bb_fn fn = &default_bounding_fn; /**< bounding function */
     bool feasibility_cuts = true; /**< feasibility cuts */
     bool optimality_cuts = true; /**< optimality cuts */
+    bool presolve = true; /**< presolve */
+    bool warm_start = true; /**< heuristic warm start */
+    size_t tt_megabytes = 0; /**< transposition table memory budget */
+    size_t threads = 1; /**< worker threads */
+    size_t split_depth = 0; /**< depth to split the tree among threads */
+    double time_limit = 0; /**< wall-clock limit in seconds */
+    unsigned long node_limit = 0; /**< visited nodes limit */
+    double progress = 0; /**< seconds between progress reports */
+    const char *binary_path = NULL; /**< converts the input to binary */
     struct bb_input in = { 0 };
 
-    for (int opt; (opt = getopt(argc, argv, "foah")) != -1;) {
+    for (int opt; (opt = getopt(argc, argv, "foapgj:d:m:T:N:i:w:h")) != -1;) {
         switch (opt) {
         case 'f':
             feasibility_cuts = false;
@@ -64,15 +57,67 @@ main(int argc, char *argv[])
         case 'a':
             fn = &alt_bounding_fn;
             break;
+        case 'p':
+            presolve = false;
+            break;
+        case 'g':
+            warm_start = false;
+            break;
+        case 'j':
+            threads = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            split_depth = strtoul(optarg, NULL, 10);
+            break;
+        case 'm':
+            tt_megabytes = strtoul(optarg, NULL, 10);
+            break;
+        case 'T':
+            time_limit = strtod(optarg, NULL);
+            break;
+        case 'N':
+            node_limit = strtoul(optarg, NULL, 10);
+            break;
+        case 'i':
+            progress = strtod(optarg, NULL);
+            break;
+        case 'w':
+            binary_path = optarg;
+            break;
         case 'h':
         default:
-            fprintf(stderr, "Usage ./%s [-f] [-o] [-a] [-h]\n", argv[0]);
+        _usage:
+            fprintf(stderr,
+                    "Usage ./%s [-f] [-o] [-a] [-p] [-g] [-j threads] "
+                    "[-d depth] [-m megabytes] [-T seconds] [-N nodes] "
+                    "[-i seconds] [-w binary] [-h] [FILE]\n",
+                    argv[0]);
             return EXIT_FAILURE;
         }
     }
 
-    if (!bb_input_parse(&in)) return EXIT_FAILURE;
+    if (optind < argc - 1) goto _usage;
+    if (!bb_input_parse(&in, optind < argc ? argv[optind] : NULL)) {
+        bb_input_cleanup(&in);
+        return EXIT_FAILURE;
+    }
+    /* convert the instance instead of solving it */
+    if (binary_path) {
+        const bool ok = bb_input_write(&in, binary_path);
+
+        bb_input_cleanup(&in);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (presolve && !bb_presolve(&in)) {
+        bb_input_cleanup(&in);
+        return EXIT_FAILURE;
+    }
     bb_input_set(&in, feasibility_cuts, optimality_cuts);
+    bb_input_set_threads(&in, threads, split_depth);
+    bb_input_set_warm_start(&in, warm_start);
+    bb_input_set_transpositions(&in, tt_megabytes << 20);
+    bb_input_set_limits(&in, time_limit, node_limit);
+    bb_input_set_progress(&in, progress);
 
     bb_solve(&in, fn);
 
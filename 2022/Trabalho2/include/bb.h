@@ -1,18 +1,41 @@
 #ifndef BB_H
 #define BB_H
 
-/** @brief Actor information */
+/**
+ * @brief Actor information
+ * @note the group set of actor `i` is kept at @ref bb_input, see
+ *      BB_SUB_S() and BB_SUB_SS()
+ */
 struct bb_actor {
     /** acting cost */
     unsigned c;
-    /** amount of groups the actor is part of */
-    size_t s;
-    /** group set this actor is part of */
-    unsigned *sub_S;
+    /** group set this actor is part of, as a bitset (group `g` is bit `g-1`) */
+    uint64_t *bits_S;
+};
+
+/**
+ * @brief Reductions applied by bb_presolve(), to map solutions back to the
+ *      input
+ */
+struct bb_presolve {
+    /** whether the input was proven infeasible */
+    bool infeasible;
+    /** amount of actors at input */
+    size_t m;
+    /** input index of each remaining actor (`NULL` if not presolved) */
+    size_t *orig;
+    /** input indexes of actors fixed in the cast */
+    size_t *fixed;
+    /** amount of actors fixed in the cast */
+    size_t fixed_m;
+    /** total cost of actors fixed in the cast */
+    unsigned fixed_c;
+    /** amount of dominated actors removed */
+    size_t dominated_m;
 };
 
 /**
- * @brief Parsed input from stdin
+ * @brief Parsed input
  * @see bb_input_parse()
  */
 struct bb_input {
@@ -24,24 +47,102 @@ struct bb_input {
     size_t n;
     /** actors set */
     struct bb_actor *A;
+    /** start of each actor's groups at `S_idx`, plus the end of the last */
+    size_t *S_off;
+    /** groups of every actor, one after the other (1-indexed) */
+    unsigned *S_idx;
+    /** amount of 64-bit words in each groups bitset */
+    size_t words_S;
+    /** storage for every actor's groups bitset */
+    uint64_t *bits_S;
+    /** single allocation backing `A`, `S_off`, `S_idx` and `bits_S` */
+    void *arena;
+    /** size of `arena` in bytes */
+    size_t arena_size;
     /** whether feasibility cuts are enabled */
     bool has_feasibility_cuts;
     /** whether optimality cuts are enabled */
     bool has_optimality_cuts;
+    /** amount of worker threads (`0` or `1` for a sequential search) */
+    size_t threads;
+    /** depth at which the tree is split among threads (`0` for automatic) */
+    size_t split_depth;
+    /** whether the incumbent is seeded by a heuristic before searching */
+    bool has_warm_start;
+    /** memory budget for the transposition table (`0` to disable it) */
+    size_t tt_bytes;
+    /** wall-clock limit for the search, in seconds (`0` for none) */
+    double time_limit;
+    /** limit of visited nodes for the search (`0` for none) */
+    unsigned long node_limit;
+    /** interval between progress reports at stderr, in seconds (`0` for
+     *      none) */
+    double progress;
+    /** reductions applied by bb_presolve() */
+    struct bb_presolve pre;
 };
 
-/** @brief Helper-type for bounding function parameter */
-typedef unsigned (*bb_fn)(
-    struct bb_actor E[], size_t Em, struct bb_actor F[], size_t Fm, size_t n);
+/** @brief Group set of actor `i` */
+#define BB_SUB_S(in, i) ((in)->S_idx + (in)->S_off[i])
+/** @brief Amount of groups of actor `i` */
+#define BB_SUB_SS(in, i) ((in)->S_off[(i) + 1] - (in)->S_off[i])
+
+/**
+ * @brief Read-only view of a search node, as seen by the bounding function
+ * @note cast actors (E set) are kept as indexes updated in place as the
+ *      search descends and backtracks, not yet decided actors (F set) are
+ *      described by their aggregated costs
+ */
+struct bb_node {
+    /** actors set */
+    const struct bb_actor *A;
+    /** indexes of cast actors */
+    const size_t *E;
+    /** amount of cast actors */
+    size_t Em;
+    /** total cost of cast actors */
+    unsigned E_c;
+    /**
+     * prefix sums of the cheapest not yet decided actors' costs (`F_c[k]`
+     *      is the sum of the `k` cheapest, for `k <= min(n, Fm)`)
+     */
+    const unsigned *F_c;
+    /** amount of not yet decided actors */
+    size_t Fm;
+};
+
+/**
+ * @brief Helper-type for bounding function parameter
+ *
+ * @param node node to be bounded
+ * @param n total amount of characters
+ * @return lower bound for the total profit
+ */
+typedef unsigned (*bb_fn)(const struct bb_node *node, size_t n);
 
 /**
  * @brief Parse and allocate resources from input
+ * @note either a text or a binary (see binary.h) instance, counts and group
+ *      indexes are validated and any malformed or missing value is reported
+ *      at stderr, a group repeated by an actor is kept only once
  *
  * @param in stores parsed input data
+ * @param path file to be read, or `NULL` for stdin
  * @return a boolean for success, either way a bb_input_cleanup() should be
  *      called
  */
-_Bool bb_input_parse(struct bb_input *in);
+_Bool bb_input_parse(struct bb_input *in, const char *path);
+
+/**
+ * @brief Write the input in the binary format (see binary.h), which
+ *      bb_input_parse() tells apart from text by its magic number
+ * @note expects an input not yet presolved
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param path file to be written
+ * @return a boolean for success
+ */
+_Bool bb_input_write(const struct bb_input *in, const char *path);
 
 /**
  * @brief Change input settings
@@ -54,6 +155,74 @@ void bb_input_set(struct bb_input *in,
                   bool feasibility_cuts,
                   bool optimality_cuts);
 
+/**
+ * @brief Change parallel search settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param threads amount of worker threads (`1` for a sequential search)
+ * @param split_depth depth at which the tree is split into subproblems
+ *      for the workers (`0` picks one from the amount of threads)
+ */
+void bb_input_set_threads(struct bb_input *in,
+                          size_t threads,
+                          size_t split_depth);
+
+/**
+ * @brief Change warm start settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param warm_start whether the incumbent is seeded by a greedy and local
+ *      search heuristic before searching
+ */
+void bb_input_set_warm_start(struct bb_input *in, bool warm_start);
+
+/**
+ * @brief Change transposition table settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param tt_bytes memory budget for the table of visited states, shared
+ *      among threads (`0` to disable it)
+ */
+void bb_input_set_transpositions(struct bb_input *in, size_t tt_bytes);
+
+/**
+ * @brief Change search limits, once either is reached the search stops
+ *      and reports the best solution found so far, along with a lower bound
+ *      for the optimal one
+ * @note limits are checked every few thousand nodes, a SIGINT or SIGTERM
+ *      stops the search the same way
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param time_limit wall-clock limit in seconds (`0` for none)
+ * @param node_limit visited nodes limit (`0` for none)
+ */
+void bb_input_set_limits(struct bb_input *in,
+                         double time_limit,
+                         unsigned long node_limit);
+
+/**
+ * @brief Change progress report settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param progress interval between reports of visited nodes, incumbent and
+ *      lower bound at stderr, in seconds (`0` to disable them)
+ */
+void bb_input_set_progress(struct bb_input *in, double progress);
+
+/**
+ * @brief Reduce the input before solving it: actors that are the only ones
+ *      covering a group are fixed in the cast, actors dominated by at least
+ *      `n` others (covering a superset of their groups at lower or equal
+ *      cost) are removed, and the remaining actors are reordered from the
+ *      cheapest per group covered
+ * @note bb_solve() maps its solution back to the input actors
+ *
+ * @param in input initialized with bb_input_parse()
+ * @return a boolean for success, either way a bb_input_cleanup() should be
+ *      called
+ */
+_Bool bb_presolve(struct bb_input *in);
+
 /**
  * @brief Cleanup the resources allocated for @ref bb_input
  *
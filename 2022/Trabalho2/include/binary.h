@@ -0,0 +1,42 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+/**
+ * @file binary.h
+ * @brief Binary instance format, an alternative to the text input that is
+ *      loaded without tokenizing
+ *
+ * Laid out in host byte order, each array right after the previous one:
+ * - @ref bb_binary_header
+ * - `m + 1` offsets of each actor's groups, as `uint64_t` (the last one is
+ *      the total of memberships)
+ * - `m` actor costs, as `uint32_t`
+ * - every actor's groups (`1 .. l`) in a row, as `uint32_t`
+ */
+
+/** @brief First bytes of a binary instance */
+#define BB_BINARY_MAGIC "ELENCOBN"
+/** @brief Length of @ref BB_BINARY_MAGIC */
+#define BB_BINARY_MAGIC_LEN 8
+/** @brief Format version written (and the only one read) */
+#define BB_BINARY_VERSION 1
+
+/** @brief Header of a binary instance */
+struct bb_binary_header {
+    /** @ref BB_BINARY_MAGIC, without its null terminator */
+    char magic[BB_BINARY_MAGIC_LEN];
+    /** @ref BB_BINARY_VERSION (also tells the byte order apart) */
+    uint32_t version;
+    /** reserved, always `0` */
+    uint32_t flags;
+    /** total amount of groups */
+    uint64_t l;
+    /** total amount of actors */
+    uint64_t m;
+    /** total amount of characters */
+    uint64_t n;
+    /** total amount of group memberships */
+    uint64_t nnz;
+};
+
+#endif /* BINARY_H */
@@ -0,0 +1,46 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+/** @brief Amount of 64-bit words needed for a bitset of `n` bits */
+#define BB_BITSET_WORDS(n) (((n) + 63) / 64)
+/** @brief Set bit `i` of bitset `b` */
+#define BB_BITSET_SET(b, i) ((b)[(i) / 64] |= (uint64_t)1 << ((i) % 64))
+/** @brief Clear bit `i` of bitset `b` */
+#define BB_BITSET_CLEAR(b, i) ((b)[(i) / 64] &= ~((uint64_t)1 << ((i) % 64)))
+/** @brief Test bit `i` of bitset `b` */
+#define BB_BITSET_TEST(b, i) (((b)[(i) / 64] >> ((i) % 64)) & 1)
+
+/**
+ * @brief Count the bits set in a bitset
+ *
+ * @param a bitset
+ * @param words amount of 64-bit words in `a`
+ * @return amount of bits set
+ */
+size_t bb_bitset_count(const uint64_t a[], size_t words);
+
+/**
+ * @brief Count the bits set in the union of two bitsets (`a | b`), without
+ *      materializing it
+ * @note vectorized with AVX2 when the running CPU supports it
+ *
+ * @param a first bitset
+ * @param b second bitset
+ * @param words amount of 64-bit words in both `a` and `b`
+ * @return amount of bits set in `a | b`
+ */
+size_t bb_bitset_union_count(const uint64_t a[],
+                             const uint64_t b[],
+                             size_t words);
+
+/**
+ * @brief Whether every bit set in `a` is also set in `b`
+ *
+ * @param a subset candidate
+ * @param b superset candidate
+ * @param words amount of 64-bit words in both `a` and `b`
+ * @return `true` if `a` is a subset of `b`
+ */
+_Bool bb_bitset_is_subset(const uint64_t a[], const uint64_t b[], size_t words);
+
+#endif /* BITSET_H */
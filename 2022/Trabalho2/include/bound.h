@@ -0,0 +1,66 @@
+#ifndef BOUND_H
+#define BOUND_H
+
+/**
+ * @brief Sums of the cheapest actor costs for every suffix of the actors
+ *      set, so that the cheapest way of filling the remaining characters
+ *      with not yet decided actors costs a single lookup
+ */
+struct bb_bound {
+    /** amount of sums per suffix (`n + 1`) */
+    size_t width;
+    /**
+     * `sums[j * width + k]` is the sum of the `k` cheapest costs among
+     *      actors `j .. m-1`, for `k <= min(n, m - j)`
+     */
+    unsigned *sums;
+    /** last actor covering each group (`m` if there is none) */
+    size_t *last_S;
+};
+
+/**
+ * @brief Sort the costs of every actors suffix and store their prefix sums,
+ *      and find the last actor covering each group
+ * @note takes `O(m * n)` time and memory
+ *
+ * @param bound bounding tables to be initialized
+ * @param in data parsed at input
+ * @return a boolean for success, either way a bb_bound_cleanup() should be
+ *      called
+ */
+_Bool bb_bound_init(struct bb_bound *bound, const struct bb_input *in);
+
+/**
+ * @brief Prefix sums of the cheapest costs among actors `j .. m-1`
+ *
+ * @param bound bounding tables initialized with bb_bound_init()
+ * @param j first actor of the suffix
+ * @return the sums, to be indexed by amount of actors
+ */
+#define BB_BOUND_SUMS(bound, j) ((bound)->sums + (j) * (bound)->width)
+
+/**
+ * @brief Whether leaving actor `l` out of the cast leaves a group that no
+ *      later actor can cover
+ *
+ * @param bound bounding tables initialized with bb_bound_init()
+ * @param l actor index
+ * @param sub_S groups of actor `l`
+ * @param sub_Ss amount of groups of actor `l`
+ * @param cover_S amount of cast actors covering each group
+ * @return `true` if the cast can't be completed without actor `l`
+ */
+_Bool bb_bound_is_last(const struct bb_bound *bound,
+                       size_t l,
+                       const unsigned sub_S[],
+                       size_t sub_Ss,
+                       const unsigned cover_S[]);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_bound
+ *
+ * @param bound bounding tables to be cleaned up
+ */
+void bb_bound_cleanup(struct bb_bound *bound);
+
+#endif /* BOUND_H */
@@ -0,0 +1,16 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+/**
+ * @brief Build a feasible cast of exactly `n` actors covering every group:
+ *      greedily pick the actor with the lowest cost per newly covered group,
+ *      fill the remaining characters with the cheapest actors left, then
+ *      swap cast actors for cheaper ones while coverage is kept
+ *
+ * @param in data parsed at input
+ * @param X stores the cast found (`m` entries)
+ * @return the cast's total profit, or `UINT_MAX` if none was found
+ */
+unsigned bb_heuristic(const struct bb_input *in, unsigned X[]);
+
+#endif /* HEURISTIC_H */
@@ -0,0 +1,76 @@
+#ifndef TT_H
+#define TT_H
+
+/** @brief Transposition table entry */
+struct bb_tt_slot {
+    /** key hash (`0` for an empty slot) */
+    uint64_t hash;
+    /** cheapest profit seen for this state */
+    unsigned P;
+    /** depth of the state */
+    unsigned l;
+    /** amount of cast actors of the state */
+    unsigned Am;
+};
+
+/**
+ * @brief Bounded-memory transposition table mapping a search state (depth,
+ *      amount of cast actors and covered groups) to the cheapest profit it
+ *      has been reached with
+ * @note the subtree below a state only depends on the state itself, so a
+ *      node reaching an already visited state at higher or equal profit
+ *      can't lead to a better solution
+ */
+struct bb_tt {
+    /** amount of slots minus one (amount of slots is a power of two) */
+    size_t mask;
+    /** amount of 64-bit words in a covered groups bitset */
+    size_t words;
+    /** slots, indexed by hash */
+    struct bb_tt_slot *slots;
+    /** covered groups bitset of each slot's state */
+    uint64_t *keys_S;
+    /** total of states found with a higher or equal profit */
+    unsigned hits;
+    /** total of states not found, or found with a higher profit */
+    unsigned misses;
+    /** total of states overwritten by a different state */
+    unsigned evictions;
+};
+
+/**
+ * @brief Allocate a transposition table
+ *
+ * @param tt transposition table to be initialized
+ * @param bytes memory budget, rounded down to a power of two amount of slots
+ * @param words amount of 64-bit words in a covered groups bitset
+ * @return a boolean for success, either way a bb_tt_cleanup() should be
+ *      called
+ */
+_Bool bb_tt_init(struct bb_tt *tt, size_t bytes, size_t words);
+
+/**
+ * @brief Look a state up, storing its profit if it's the cheapest seen
+ *
+ * @param tt transposition table initialized with bb_tt_init()
+ * @param l depth of the state
+ * @param Am amount of cast actors
+ * @param bits_S covered groups bitset
+ * @param P profit of cast actors
+ * @return `true` if the state has already been reached with a lower or
+ *      equal profit (and the node can be pruned)
+ */
+_Bool bb_tt_probe(struct bb_tt *tt,
+                  size_t l,
+                  size_t Am,
+                  const uint64_t bits_S[],
+                  unsigned P);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_tt
+ *
+ * @param tt transposition table to be cleaned up
+ */
+void bb_tt_cleanup(struct bb_tt *tt);
+
+#endif /* TT_H */
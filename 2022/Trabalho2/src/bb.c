@@ -1,13 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <limits.h>
 
 #include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/time.h>
 
 #include "bb.h"
+#include "bitset.h"
+#include "bound.h"
+#include "heuristic.h"
+#include "pool.h"
+#include "tt.h"
 
 /** @brief Max size for the Cl set */
 #define CL_SIZE_MAX 2
@@ -20,22 +30,101 @@ static bool _CL_ZERO[CL_SIZE_MAX] = { false };
 #define CL_ONE_OR_ZERO (&_CL_ONE_OR_ZERO)
 static bool _CL_ONE_OR_ZERO[CL_SIZE_MAX] = { true, false };
 
+/** @brief Split depth picked when none is given, per worker thread */
+#define SPLIT_TASKS_PER_THREAD 16
+
+/** @brief Visited nodes between checks for search limits and progress */
+#define CHECK_INTERVAL 1024
+
+/** @brief Milliseconds elapsed between two `struct timeval` */
+#define ELAPSED_MS(t1, t2)                                                    \
+    (((t2).tv_sec - (t1).tv_sec) * 1000.0                                     \
+     + ((t2).tv_usec - (t1).tv_usec) / 1000.0)
+
+/** @brief Best solution found so far, shared by every worker */
+struct _bb_opt {
+    /** current optimal profit */
+    _Atomic unsigned P;
+    /** current optimal solution */
+    unsigned *X;
+    /** serializes updates to the optimal solution */
+    pthread_mutex_t lock;
+};
+
+/** @brief Current optimal profit, for pruning */
+#define OPT_P(ctx) atomic_load_explicit(&(ctx)->opt->P, memory_order_relaxed)
+
+/** @brief Subproblems obtained by splitting the tree at a fixed depth */
+struct _bb_tasks {
+    /** split depth (amount of fixed choices per subproblem) */
+    size_t depth;
+    /** amount of subproblems */
+    size_t count;
+    /** amount of subproblems that fit in `X` */
+    size_t capacity;
+    /** fixed choices, `depth` per subproblem */
+    bool *X;
+    /** lower bound of each subproblem */
+    unsigned *LB;
+};
+
+/** @brief Reason for the search to stop before exhausting the tree */
+enum _bb_stop {
+    _BB_STOP_NONE = 0,
+    _BB_STOP_TIME,
+    _BB_STOP_NODES,
+    _BB_STOP_SIGNAL
+};
+
+/** @brief Set by _bb_signal_handler() once SIGINT or SIGTERM is received */
+static volatile sig_atomic_t _bb_signaled;
+
+/** @brief Search limits and progress, shared by every worker */
+struct _bb_run {
+    /** when the search started */
+    struct timespec start;
+    /** a @ref _bb_stop, set once by whoever notices a limit was reached */
+    _Atomic int stop;
+    /** visited nodes published by every context */
+    _Atomic unsigned long nodes;
+    /** milliseconds since `start` at which the next progress report is due */
+    _Atomic unsigned long next_report;
+    /** lower bound of the work left to each context (`UINT_MAX` if idle) */
+    _Atomic unsigned *LB;
+    /** amount of contexts in `LB` */
+    size_t nctx;
+    /** subproblems split so far (`NULL` for a sequential search) */
+    const struct _bb_tasks *tasks;
+    /** subproblems not yet taken by a worker (`NULL` until dealt) */
+    struct bb_pool *pool;
+};
+
 /** @brief "Global" references structure */
 struct _bb_ctx {
     /** bounding function */
     bb_fn B;
-    /** current optimal profit */
-    unsigned opt_P;
-    /** current optimal solution */
-    unsigned *opt_X;
-    /** cast actors */
-    struct bb_actor *E;
-    /** not cast actors */
-    struct bb_actor *F;
+    /** current optimal profit and solution (shared among threads) */
+    struct _bb_opt *opt;
+    /** where subproblems are stored while splitting, `NULL` otherwise */
+    struct _bb_tasks *split;
+    /** cheapest costs of each actors suffix (shared among threads) */
+    const struct bb_bound *bound;
+    /** indexes of cast actors, in the order they were cast */
+    size_t *E;
     /** current feasible solution */
     bool *X;
-    /** helper lens for counting distinct groups */
-    bool *lens_S;
+    /** amount of cast actors in X and E (kept up to date by _bb_X_set()) */
+    size_t sub_Am;
+    /** total profit of cast actors in X (kept up to date by _bb_X_set()) */
+    unsigned P;
+    /** amount of cast actors covering each group */
+    unsigned *cover_S;
+    /** amount of groups covered by cast actors */
+    size_t sub_Sm;
+    /** groups covered by cast actors, as a bitset */
+    uint64_t *bits_S;
+    /** states already visited (if `in->tt_bytes` is set) */
+    struct bb_tt tt;
     /** @ref CL_EMPTY, @ref CL_ONE_OR_ZERO or @ref CL_ZERO */
     bool (*Cl)[CL_SIZE_MAX];
     /** total of visited nodes */
@@ -44,78 +133,319 @@ struct _bb_ctx {
     unsigned optimality_cuts;
     /** total of feasibility cuts */
     unsigned feasibility_cuts;
+    /** search limits and progress (shared among threads) */
+    struct _bb_run *run;
+    /** this context's slot at `run->LB` */
+    _Atomic unsigned *run_LB;
+    /** lower bound of the node at each depth of the current path */
+    unsigned *node_LB;
+    /** lower bound of the next sibling to visit at each depth of the
+     *      current path (`UINT_MAX` if none) */
+    unsigned *next_LB;
+    /** depth of the subtree being searched */
+    size_t root;
+    /** visited nodes already added to `run->nodes` */
+    unsigned published_nodes;
+    /** lower bound of the work left when the search was stopped */
+    unsigned open_LB;
+    /** whether the search was stopped while this context was searching */
+    bool stopped;
 };
 
 /**
- * @brief Obtains count of casted actors
+ * @brief Set the choice for actor `i`, updating the cast set, profit and
+ *      groups coverage incrementally
+ * @note actors must be uncast in the reverse order they were cast
  *
  * @param in parsed input
  * @param ctx "global" references
- * @return total count of casted actors
+ * @param i actor index
+ * @param choice whether actor `i` is cast
  */
-static size_t
-_bb_actors_count(const struct bb_input *in, const struct _bb_ctx *ctx)
+static void
+_bb_X_set(const struct bb_input *in,
+          struct _bb_ctx *ctx,
+          size_t i,
+          bool choice)
 {
-    size_t total_a = 0;
-    for (size_t i = 0; i < in->m; ++i)
-        total_a += ctx->X[i];
-    return total_a;
+    const unsigned *sub_S = BB_SUB_S(in, i);
+    const size_t sub_Ss = BB_SUB_SS(in, i);
+
+    if (ctx->X[i] == choice) return;
+
+    ctx->X[i] = choice;
+    if (choice) {
+        ctx->E[ctx->sub_Am++] = i;
+        ctx->P += in->A[i].c;
+        for (size_t j = 0; j < sub_Ss; ++j)
+            if (ctx->cover_S[sub_S[j] - 1]++ == 0) {
+                BB_BITSET_SET(ctx->bits_S, sub_S[j] - 1);
+                ++ctx->sub_Sm;
+            }
+    }
+    else {
+        --ctx->sub_Am;
+        ctx->P -= in->A[i].c;
+        for (size_t j = 0; j < sub_Ss; ++j)
+            if (--ctx->cover_S[sub_S[j] - 1] == 0) {
+                BB_BITSET_CLEAR(ctx->bits_S, sub_S[j] - 1);
+                --ctx->sub_Sm;
+            }
+    }
 }
 
 /**
- * @brief Obtains count of groups covered by casted actors
+ * @brief Store the current feasible solution as the optimal one, unless
+ *      another thread has found a better solution meanwhile
  *
  * @param in parsed input
  * @param ctx "global" references
- * @param sub_S optional groups subset to be added with groups
- *      covered by casted actors
- * @param sub_Ss amount of elements in the groups subsets
- * @return total count of casted actors
  */
-static size_t
-_bb_group_count(const struct bb_input *in,
-                struct _bb_ctx *ctx,
-                const unsigned sub_S[],
-                size_t sub_Ss)
+static void
+_bb_opt_update(const struct bb_input *in, struct _bb_ctx *ctx)
 {
-    size_t total_s = 0;
-    if (sub_S != NULL) {
-        for (size_t i = 0; i < sub_Ss; ++i) {
-            if (ctx->lens_S[i] == true) continue;
-
-            ctx->lens_S[sub_S[i] - 1] = true;
-            ++total_s;
-        }
+    pthread_mutex_lock(&ctx->opt->lock);
+    if (ctx->P < OPT_P(ctx)) {
+        for (size_t i = 0; i < in->m; ++i)
+            ctx->opt->X[i] = ctx->X[i];
+        atomic_store_explicit(&ctx->opt->P, ctx->P, memory_order_relaxed);
     }
-    for (size_t i = 0; i < in->m; ++i) {
-        if (ctx->X[i] == false) continue;
+    pthread_mutex_unlock(&ctx->opt->lock);
+}
 
-        for (size_t j = 0; j < in->A[i].s; ++j) {
-            if (ctx->lens_S[in->A[i].sub_S[j] - 1] == true) continue;
+/**
+ * @brief Store the current choices as a new subproblem
+ *
+ * @param tasks subproblems set
+ * @param X current feasible solution
+ * @param LB lower bound of the subproblem
+ */
+static void
+_bb_tasks_push(struct _bb_tasks *tasks, const bool X[], unsigned LB)
+{
+    if (tasks->count == tasks->capacity) {
+        const size_t capacity = tasks->capacity ? 2 * tasks->capacity : 64;
+        bool *tmp = realloc(tasks->X, capacity * tasks->depth * sizeof *tmp);
+        unsigned *tmp_LB;
 
-            ctx->lens_S[in->A[i].sub_S[j] - 1] = true;
-            ++total_s;
+        if (!tmp) {
+            perror("realloc()");
+            exit(EXIT_FAILURE);
+        }
+        tasks->X = tmp;
+        if (!(tmp_LB = realloc(tasks->LB, capacity * sizeof *tmp_LB))) {
+            perror("realloc()");
+            exit(EXIT_FAILURE);
         }
+        tasks->LB = tmp_LB;
+        tasks->capacity = capacity;
     }
-    for (size_t i = 0; i < in->l; ++i)
-        ctx->lens_S[i] = 0;
-    return total_s;
+    memcpy(tasks->X + tasks->count * tasks->depth, X,
+           tasks->depth * sizeof *X);
+    tasks->LB[tasks->count++] = LB;
 }
 
 /**
- * @brief Total profit for current feasible solution
+ * @brief Handle SIGINT and SIGTERM by asking the search to stop
+ *
+ * @param signum received signal
+ */
+static void
+_bb_signal_handler(int signum)
+{
+    (void)signum;
+    _bb_signaled = 1;
+}
+
+/**
+ * @brief Milliseconds elapsed since the search started
+ *
+ * @param run search limits and progress
+ * @return elapsed milliseconds
+ */
+static double
+_bb_run_elapsed_ms(const struct _bb_run *run)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - run->start.tv_sec) * 1000.0
+           + (now.tv_nsec - run->start.tv_nsec) / 1000000.0;
+}
+
+/**
+ * @brief Lower bound of the work left to a context: the node being visited
+ *      and the siblings not yet visited along its path
  *
- * @param in parsed input
  * @param ctx "global" references
- * @return total profit
+ * @param l depth of the node being visited
+ * @return lower bound for the profit of any solution still to be visited
  */
 static unsigned
-_bb_profit(const struct bb_input *in, const struct _bb_ctx *ctx)
+_bb_ctx_LB(const struct _bb_ctx *ctx, size_t l)
+{
+    unsigned LB = ctx->node_LB[l];
+
+    for (size_t d = ctx->root + 1; d <= l; ++d)
+        if (ctx->next_LB[d] < LB) LB = ctx->next_LB[d];
+    return LB;
+}
+
+/** @brief Lowest bound among pending subproblems, see _bb_task_LB() */
+struct _bb_pending {
+    /** subproblems */
+    const struct _bb_tasks *tasks;
+    /** lowest bound so far */
+    unsigned LB;
+};
+
+/**
+ * @brief Lower the bound to a pending subproblem's, see bb_pool_pending()
+ *
+ * @param task pending subproblem
+ * @param data a @ref _bb_pending
+ */
+static void
+_bb_task_LB(size_t task, void *data)
+{
+    struct _bb_pending *pending = data;
+
+    if (pending->tasks->LB[task] < pending->LB)
+        pending->LB = pending->tasks->LB[task];
+}
+
+/**
+ * @brief Lower bound of the work left to every context and of the pending
+ *      subproblems
+ * @note contexts publish their bound every @ref CHECK_INTERVAL nodes, a
+ *      stale bound is still valid as the work left only shrinks
+ *
+ * @param run search limits and progress
+ * @return lower bound for the profit of any solution still to be visited
+ */
+static unsigned
+_bb_run_LB(struct _bb_run *run)
+{
+    struct _bb_pending pending = { .tasks = run->tasks, .LB = UINT_MAX };
+    unsigned LB;
+
+    /* pending subproblems first: one taken meanwhile has its worker's slot
+     *      at 0 until it publishes the subproblem's bound */
+    if (run->pool)
+        bb_pool_pending(run->pool, &_bb_task_LB, &pending);
+    else if (run->tasks)
+        for (size_t i = 0; i < run->tasks->count; ++i)
+            _bb_task_LB(i, &pending);
+    LB = pending.LB;
+    for (size_t i = 0; i < run->nctx; ++i) {
+        const unsigned ctx_LB = atomic_load(&run->LB[i]);
+        if (ctx_LB < LB) LB = ctx_LB;
+    }
+    return LB;
+}
+
+/**
+ * @brief Print a value offset by the actors fixed at bb_presolve(), or
+ *      "none" if there's no value
+ *
+ * @param buf stores the printed value
+ * @param size size of `buf`
+ * @param in data parsed at input
+ * @param value value to be printed (`UINT_MAX` for none)
+ * @return `buf`
+ */
+static char *
+_bb_value_str(char buf[],
+              size_t size,
+              const struct bb_input *in,
+              unsigned value)
 {
-    unsigned P = 0;
-    for (size_t i = 0; i < in->m; ++i)
-        P += ctx->X[i] * in->A[i].c;
-    return P;
+    if (value == UINT_MAX)
+        snprintf(buf, size, "none");
+    else
+        snprintf(buf, size, "%u", value + in->pre.fixed_c);
+    return buf;
+}
+
+/**
+ * @brief Print a progress report at stderr
+ *
+ * @param in data parsed at input
+ * @param ctx "global" references
+ * @param elapsed_ms milliseconds since the search started
+ * @param nodes visited nodes published so far
+ */
+static void
+_bb_progress_print(const struct bb_input *in,
+                   struct _bb_ctx *ctx,
+                   double elapsed_ms,
+                   unsigned long nodes)
+{
+    const unsigned P = OPT_P(ctx);
+    unsigned LB = _bb_run_LB(ctx->run);
+    char P_str[32], LB_str[32];
+
+    if (LB > P) LB = P;
+    fprintf(stderr,
+            "Progress: %.1f s, %lu nodes (%.0f nodes/s), incumbent: %s, "
+            "bound: %s\n",
+            elapsed_ms / 1000, nodes,
+            elapsed_ms > 0 ? nodes / (elapsed_ms / 1000) : 0,
+            _bb_value_str(P_str, sizeof P_str, in, P),
+            _bb_value_str(LB_str, sizeof LB_str, in, LB));
+}
+
+/**
+ * @brief Publish this context's progress, report it if due and check
+ *      whether the search must stop
+ * @note once stopped, the context's lower bound is kept at `ctx->open_LB`
+ *
+ * @param in data parsed at input
+ * @param ctx "global" references
+ * @param l depth of the node being visited
+ * @return `true` if the search must stop
+ */
+static bool
+_bb_check(const struct bb_input *in, struct _bb_ctx *ctx, size_t l)
+{
+    struct _bb_run *run = ctx->run;
+    const double elapsed_ms = _bb_run_elapsed_ms(run);
+    const unsigned long nodes =
+        atomic_fetch_add(&run->nodes,
+                         ctx->visited_nodes - ctx->published_nodes)
+        + (ctx->visited_nodes - ctx->published_nodes);
+    int stop = _BB_STOP_NONE;
+
+    ctx->published_nodes = ctx->visited_nodes;
+    atomic_store(ctx->run_LB, _bb_ctx_LB(ctx, l));
+
+    if (_bb_signaled)
+        stop = _BB_STOP_SIGNAL;
+    else if (in->time_limit && elapsed_ms >= in->time_limit * 1000)
+        stop = _BB_STOP_TIME;
+    else if (in->node_limit && nodes >= in->node_limit)
+        stop = _BB_STOP_NODES;
+    if (stop != _BB_STOP_NONE) {
+        int expected = _BB_STOP_NONE;
+        atomic_compare_exchange_strong(&run->stop, &expected, stop);
+    }
+
+    if (in->progress) {
+        unsigned long due = atomic_load(&run->next_report);
+
+        /* only whoever moves the deadline forward reports */
+        if (elapsed_ms >= due
+            && atomic_compare_exchange_strong(
+                &run->next_report, &due,
+                (unsigned long)(elapsed_ms + in->progress * 1000)))
+            _bb_progress_print(in, ctx, elapsed_ms, nodes);
+    }
+
+    if (atomic_load(&run->stop) == _BB_STOP_NONE) return false;
+
+    ctx->stopped = true;
+    ctx->open_LB = _bb_ctx_LB(ctx, l);
+    return true;
 }
 
 /**
@@ -143,7 +473,9 @@ _bb_Cl_compute(struct bb_input *in,
             ctx->Cl = CL_ZERO;
             return;
         }
-        if (in->l > _bb_group_count(in, ctx, in->A[l].sub_S, in->A[l].s)) {
+        if (in->l
+            > bb_bitset_union_count(ctx->bits_S, in->A[l].bits_S, in->words_S))
+        {
             ctx->Cl = CL_ONE_OR_ZERO;
             return;
         }
@@ -163,37 +495,53 @@ _bb_Cl_compute(struct bb_input *in,
 static void
 _bb_solve(struct bb_input *in, struct _bb_ctx *ctx, size_t l)
 {
-    const size_t sub_Am = _bb_actors_count(in, ctx);
+    const size_t sub_Am = ctx->sub_Am;
     unsigned nextbound[CL_SIZE_MAX];
     bool nextchoice[CL_SIZE_MAX];
     size_t count = 0;
 
+    if (ctx->split && l == ctx->split->depth) {
+        _bb_tasks_push(ctx->split, ctx->X, ctx->node_LB[l]);
+        return;
+    }
+
     ++ctx->visited_nodes;
 
-    if (sub_Am == in->n && _bb_group_count(in, ctx, NULL, 0) == in->l) {
-        const unsigned P = _bb_profit(in, ctx);
-        if (P < ctx->opt_P) {
-            ctx->opt_P = P;
-            for (size_t i = 0; i < in->m; ++i)
-                ctx->opt_X[i] = ctx->X[i];
-        }
-    }
+    if (sub_Am == in->n && ctx->sub_Sm == in->l && ctx->P < OPT_P(ctx))
+        _bb_opt_update(in, ctx);
+
+    if (ctx->visited_nodes % CHECK_INTERVAL == 0 && _bb_check(in, ctx, l))
+        return;
+
+    /* same state already reached at a lower or equal profit */
+    if (in->tt_bytes && l < in->m
+        && bb_tt_probe(&ctx->tt, l, sub_Am, ctx->bits_S, ctx->P))
+        return;
 
     _bb_Cl_compute(in, ctx, l, sub_Am);
     if (ctx->Cl != CL_EMPTY) {
-        /* E = currently cast actors; F = not yet cast actors */
-        size_t En = 0, Fn = 0;
-        for (size_t i = 0; i < in->m; ++i) {
-            if (ctx->X[i])
-                ctx->E[En++] = in->A[i];
-            else
-                ctx->F[Fn++] = in->A[i];
-        }
-        /* get nextchoice and nextbounds */
+        /* E = currently cast actors (plus actor l, for choice 1);
+         *      F = actors not yet decided (l+1 .. m-1) */
+        struct bb_node node = { .A = in->A,
+                                .E = ctx->E,
+                                .F_c = BB_BOUND_SUMS(ctx->bound, l + 1),
+                                .Fm = in->m - (l + 1) };
+        ctx->E[sub_Am] = l; // scratch slot past the cast set, for choice 1
+        /* get nextchoice and nextbounds, as if X[l] was set to each choice
+         *      (leaving out the last actor of an uncovered group can't lead
+         *      to a feasible solution) */
         count = (ctx->Cl == CL_ONE_OR_ZERO) ? CL_SIZE_MAX : 1;
         for (size_t i = 0; i < count; ++i) {
             nextchoice[i] = (*ctx->Cl)[i];
-            nextbound[i] = ctx->B(ctx->E, En, ctx->F, Fn, in->n);
+            if (!nextchoice[i]
+                && bb_bound_is_last(ctx->bound, l, BB_SUB_S(in, l),
+                                    BB_SUB_SS(in, l), ctx->cover_S))
+                nextbound[i] = UINT_MAX;
+            else {
+                node.Em = sub_Am + nextchoice[i];
+                node.E_c = ctx->P + nextchoice[i] * in->A[l].c;
+                nextbound[i] = ctx->B(&node, in->n);
+            }
         }
         /* sort nextchoice and nextbound */
         if (ctx->Cl == CL_ONE_OR_ZERO && nextbound[1] < nextbound[0]) {
@@ -207,79 +555,389 @@ _bb_solve(struct bb_input *in, struct _bb_ctx *ctx, size_t l)
     }
 
     for (size_t i = 0; i < count; ++i) {
-        if (in->has_optimality_cuts && nextbound[i] >= ctx->opt_P) {
+        if (in->has_optimality_cuts && nextbound[i] >= OPT_P(ctx)) {
             ++ctx->optimality_cuts;
-            return;
+            break;
         }
-        ctx->X[l] = nextchoice[i];
+        ctx->node_LB[l + 1] = nextbound[i];
+        ctx->next_LB[l + 1] = (i + 1 < count) ? nextbound[i + 1] : UINT_MAX;
+        _bb_X_set(in, ctx, l, nextchoice[i]);
         _bb_solve(in, ctx, l + 1);
+        if (ctx->stopped) break;
+    }
+    /* backtrack, so that a node's state only depends on its own choices */
+    if (count != 0) _bb_X_set(in, ctx, l, false);
+}
+
+/**
+ * @brief Allocate a context's per-thread scratch and zero its state
+ *
+ * @param in data parsed at input
+ * @param ctx context to be initialized
+ * @param fn_bounding bounding function
+ * @param bound shared bounding tables
+ * @param opt shared optimal solution
+ * @param run shared search limits and progress
+ * @param id this context's slot at `run->LB`
+ */
+static void
+_bb_ctx_init(const struct bb_input *in,
+             struct _bb_ctx *ctx,
+             bb_fn fn_bounding,
+             const struct bb_bound *bound,
+             struct _bb_opt *opt,
+             struct _bb_run *run,
+             size_t id)
+{
+    *ctx = (struct _bb_ctx){
+        .B = fn_bounding,
+        .opt = opt,
+        .bound = bound,
+        .E = calloc(in->m, sizeof *ctx->E),
+        .X = calloc(in->m, sizeof *ctx->X),
+        .cover_S = calloc(in->l, sizeof *ctx->cover_S),
+        .bits_S = calloc(in->words_S, sizeof *ctx->bits_S),
+        .run = run,
+        .run_LB = &run->LB[id],
+        .node_LB = calloc(in->m + 1, sizeof *ctx->node_LB),
+        .next_LB = calloc(in->m + 1, sizeof *ctx->next_LB),
+        .open_LB = UINT_MAX,
+    };
+    if (!ctx->E || !ctx->X || !ctx->cover_S || !ctx->bits_S || !ctx->node_LB
+        || !ctx->next_LB)
+    {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
+    }
+    if (in->tt_bytes) {
+        /* split budget among workers, plus the context splitting the tree */
+        const size_t nctx = in->threads > 1 ? in->threads + 1 : 1;
+        if (!bb_tt_init(&ctx->tt, in->tt_bytes / nctx, in->words_S))
+            exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Cleanup the resources allocated by _bb_ctx_init()
+ *
+ * @param ctx context to be cleaned up
+ */
+static void
+_bb_ctx_cleanup(struct _bb_ctx *ctx)
+{
+    free(ctx->E);
+    free(ctx->X);
+    free(ctx->cover_S);
+    free(ctx->bits_S);
+    free(ctx->node_LB);
+    free(ctx->next_LB);
+    bb_tt_cleanup(&ctx->tt);
+}
+
+/** @brief Worker thread of the parallel search */
+struct _bb_worker {
+    /** thread handle */
+    pthread_t tid;
+    /** worker index within the pool */
+    size_t id;
+    /** data parsed at input */
+    struct bb_input *in;
+    /** subproblems to be solved */
+    const struct _bb_tasks *tasks;
+    /** work-stealing pool of `tasks` */
+    struct bb_pool *pool;
+    /** this worker's own references */
+    struct _bb_ctx ctx;
+};
+
+/**
+ * @brief Solve subproblems until there are none left to take or steal
+ *
+ * @param arg a @ref _bb_worker
+ * @return `NULL`
+ */
+static void *
+_bb_worker_run(void *arg)
+{
+    struct _bb_worker *w = arg;
+    const size_t depth = w->tasks->depth;
+    size_t task;
+
+    w->ctx.root = depth;
+    while (atomic_load(&w->ctx.run->stop) == _BB_STOP_NONE) {
+        const bool *X;
+
+        /* a task being taken is neither pending nor published yet */
+        atomic_store(w->ctx.run_LB, 0);
+        if (!bb_pool_take(w->pool, w->id, &task)) break;
+        X = w->tasks->X + task * depth;
+        w->ctx.node_LB[depth] = w->tasks->LB[task];
+        atomic_store(w->ctx.run_LB, w->tasks->LB[task]);
+
+        /* undo the previous subproblem's choices in reverse order first */
+        for (size_t i = depth; i-- > 0;)
+            _bb_X_set(w->in, &w->ctx, i, false);
+        for (size_t i = 0; i < depth; ++i)
+            _bb_X_set(w->in, &w->ctx, i, X[i]);
+        _bb_solve(w->in, &w->ctx, depth);
+        if (w->ctx.stopped) break;
+    }
+    atomic_store(w->ctx.run_LB, UINT_MAX);
+    return NULL;
+}
+
+/**
+ * @brief Split the tree at `in->split_depth` and solve the subproblems
+ *      with `in->threads` workers, adding their counters to `ctx`
+ *
+ * @param in data parsed at input
+ * @param ctx "global" references
+ * @param steals stores amount of subproblems stolen by idle workers
+ * @return amount of subproblems
+ */
+static size_t
+_bb_solve_parallel(struct bb_input *in, struct _bb_ctx *ctx, unsigned *steals)
+{
+    struct _bb_tasks tasks = { .depth = in->split_depth };
+    struct _bb_worker *workers;
+    struct bb_pool pool;
+
+    if (tasks.depth == 0)
+        while (tasks.depth < in->m
+               && ((size_t)1 << tasks.depth)
+                      < SPLIT_TASKS_PER_THREAD * in->threads)
+            ++tasks.depth;
+    if (tasks.depth > in->m) tasks.depth = in->m;
+
+    /* nodes above the split depth are visited here, and may already find
+     *      feasible solutions */
+    ctx->split = &tasks;
+    ctx->run->tasks = &tasks;
+    _bb_solve(in, ctx, 0);
+    ctx->split = NULL;
+    atomic_store(ctx->run_LB, UINT_MAX);
+
+    if (!bb_pool_init(&pool, in->threads, tasks.count)) exit(EXIT_FAILURE);
+    ctx->run->pool = &pool;
+    if (!(workers = calloc(in->threads, sizeof *workers))) {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
     }
+    for (size_t i = 0; i < in->threads; ++i) {
+        struct _bb_worker *w = &workers[i];
+
+        *w = (struct _bb_worker){
+            .id = i, .in = in, .tasks = &tasks, .pool = &pool
+        };
+        _bb_ctx_init(in, &w->ctx, ctx->B, ctx->bound, ctx->opt, ctx->run,
+                     i + 1);
+        if ((errno = pthread_create(&w->tid, NULL, &_bb_worker_run, w))) {
+            perror("pthread_create()");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (size_t i = 0; i < in->threads; ++i) {
+        struct _bb_worker *w = &workers[i];
+
+        pthread_join(w->tid, NULL);
+        ctx->visited_nodes += w->ctx.visited_nodes;
+        ctx->optimality_cuts += w->ctx.optimality_cuts;
+        ctx->feasibility_cuts += w->ctx.feasibility_cuts;
+        ctx->tt.hits += w->ctx.tt.hits;
+        ctx->tt.misses += w->ctx.tt.misses;
+        ctx->tt.evictions += w->ctx.tt.evictions;
+        if (w->ctx.open_LB < ctx->open_LB) ctx->open_LB = w->ctx.open_LB;
+        _bb_ctx_cleanup(&w->ctx);
+    }
+    *steals = atomic_load(&pool.steals);
+
+    /* subproblems left untouched by a stopped search are still open */
+    if (atomic_load(&ctx->run->stop) != _BB_STOP_NONE) {
+        struct _bb_pending pending = { .tasks = &tasks, .LB = UINT_MAX };
+
+        bb_pool_pending(&pool, &_bb_task_LB, &pending);
+        if (pending.LB < ctx->open_LB) ctx->open_LB = pending.LB;
+    }
+    ctx->run->tasks = NULL;
+    ctx->run->pool = NULL;
+
+    free(workers);
+    bb_pool_cleanup(&pool);
+    free(tasks.X);
+    free(tasks.LB);
+
+    return tasks.count;
 }
 
 /**
- * @brief Prints the encountered optimal solution
+ * @brief Prints the encountered optimal solution, in terms of the input
+ *      actors (see bb_presolve())
  *
  * @param in data parsed at input
  * @param ctx "global" references
+ * @param stopped whether the search was stopped before exhausting the tree
  */
 static void
-_bb_solution_print(struct bb_input *in, struct _bb_ctx *ctx)
+_bb_solution_print(struct bb_input *in, struct _bb_ctx *ctx, bool stopped)
 {
-    ssize_t i, last_idx;
+    const unsigned opt_P = OPT_P(ctx);
+    const unsigned *opt_X = ctx->opt->X;
+    const size_t m = in->pre.orig ? in->pre.m : in->m;
+    bool *cast;
+    size_t i, last_idx = 0;
 
-    if (ctx->opt_P == UINT_MAX) {
-        puts("Inviável");
+    if (opt_P == UINT_MAX) {
+        puts(stopped ? "Sem solução" : "Inviável");
         return;
     }
-    for (i = in->m - 1; i >= 0; --i) {
-        if (ctx->opt_X[i] == true) {
-            last_idx = i;
-            break;
-        }
+    if (!(cast = calloc(m, sizeof *cast))) {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
     }
+    for (i = 0; i < in->pre.fixed_m; ++i)
+        cast[in->pre.fixed[i]] = true;
+    for (i = 0; i < in->m; ++i)
+        if (opt_X[i] == true) cast[in->pre.orig ? in->pre.orig[i] : i] = true;
+
+    for (i = 0; i < m; ++i)
+        if (cast[i] == true) last_idx = i;
     for (i = 0; i < last_idx; ++i)
-        if (ctx->opt_X[i] == true) printf("%zu ", i + 1);
-    if (ctx->opt_X[i] == true) printf("%zu\n", i + 1);
-    printf("%u\n", ctx->opt_P);
+        if (cast[i] == true) printf("%zu ", i + 1);
+    if (m != 0 && cast[i] == true) printf("%zu", i + 1);
+    printf("\n%u\n", opt_P + in->pre.fixed_c);
+    free(cast);
 }
 
 void
 bb_solve(struct bb_input *in, bb_fn fn_bounding)
 {
-    struct _bb_ctx ctx = { .B = fn_bounding,
-                           .opt_P = UINT_MAX,
-                           .opt_X = calloc(in->m, sizeof *ctx.opt_X),
-                           .E = calloc(in->m, sizeof *ctx.E),
-                           .F = calloc(in->m, sizeof *ctx.F),
-                           .X = calloc(in->m, sizeof *ctx.X),
-                           .lens_S = calloc(in->l, sizeof *ctx.lens_S) };
+    struct _bb_opt opt = { .P = UINT_MAX,
+                           .X = calloc(in->m, sizeof *opt.X) };
+    struct _bb_run run = { .nctx = in->threads > 1 ? in->threads + 1 : 1 };
+    struct sigaction sa = { .sa_handler = &_bb_signal_handler,
+                            .sa_flags = SA_RESETHAND },
+                     old_sigint, old_sigterm;
+    struct bb_bound bound;
+    struct _bb_ctx ctx;
     struct timeval t1, t2;
-    double elapsed_time;
+    double elapsed_time, heuristic_time = 0;
+    unsigned heuristic_P = UINT_MAX;
+    size_t ntasks = 0;
+    unsigned steals = 0;
+    int stop;
 
-    if (!ctx.opt_X || !ctx.E || !ctx.F || !ctx.X || !ctx.lens_S) {
+    if (!opt.X || !(run.LB = calloc(run.nctx, sizeof *run.LB))) {
         perror("calloc()");
         exit(EXIT_FAILURE);
     }
+    if (!bb_bound_init(&bound, in)) exit(EXIT_FAILURE);
+    pthread_mutex_init(&opt.lock, NULL);
+    for (size_t i = 0; i < run.nctx; ++i)
+        atomic_init(&run.LB[i], UINT_MAX);
+    _bb_ctx_init(in, &ctx, fn_bounding, &bound, &opt, &run, 0);
+
+    /* a first signal stops the search gracefully, a second one kills it */
+    _bb_signaled = 0;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, &old_sigint);
+    sigaction(SIGTERM, &sa, &old_sigterm);
+    clock_gettime(CLOCK_MONOTONIC, &run.start);
+    atomic_init(&run.next_report,
+                (unsigned long)(in->progress * 1000));
+
+    if (in->has_warm_start && !in->pre.infeasible) {
+        /* seed the incumbent, so that optimality cuts fire from the start */
+        gettimeofday(&t1, NULL);
+        heuristic_P = bb_heuristic(in, opt.X);
+        gettimeofday(&t2, NULL);
+        heuristic_time = ELAPSED_MS(t1, t2);
+        atomic_store(&opt.P, heuristic_P);
+    }
 
     gettimeofday(&t1, NULL);
-    _bb_solve(in, &ctx, 0);
+    if (in->pre.infeasible)
+        ; // proven by bb_presolve(), nothing to search
+    else {
+        /* root bound, no actor decided yet */
+        const struct bb_node root = { .A = in->A,
+                                      .E = ctx.E,
+                                      .F_c = BB_BOUND_SUMS(&bound, 0),
+                                      .Fm = in->m };
+
+        ctx.node_LB[0] = fn_bounding(&root, in->n);
+        atomic_store(ctx.run_LB, ctx.node_LB[0]);
+        if (in->threads > 1)
+            ntasks = _bb_solve_parallel(in, &ctx, &steals);
+        else
+            _bb_solve(in, &ctx, 0);
+    }
     gettimeofday(&t2, NULL);
 
-    elapsed_time =
-        (t2.tv_sec - t1.tv_sec) * 1000.0 + (t2.tv_usec - t1.tv_usec) / 1000.0;
+    sigaction(SIGINT, &old_sigint, NULL);
+    sigaction(SIGTERM, &old_sigterm, NULL);
+    elapsed_time = ELAPSED_MS(t1, t2);
+    stop = atomic_load(&run.stop);
 
-    _bb_solution_print(in, &ctx);
+    _bb_solution_print(in, &ctx, stop != _BB_STOP_NONE);
     fprintf(stderr,
             "Visited nodes: %u\n"
             "Elapsed time: %.17G ms\n"
             "Optimality cuts: %u\n"
-            "Feasibility cuts: %u\n",
+            "Feasibility cuts: %u\n"
+            "Input memory: %zu bytes\n",
             ctx.visited_nodes, elapsed_time, ctx.optimality_cuts,
-            ctx.feasibility_cuts);
+            ctx.feasibility_cuts, in->arena_size);
+    if (in->threads > 1)
+        fprintf(stderr,
+                "Threads: %zu\n"
+                "Subproblems: %zu\n"
+                "Steals: %u\n",
+                in->threads, ntasks, steals);
+    if (in->pre.orig || in->pre.infeasible)
+        fprintf(stderr,
+                "Fixed actors: %zu\n"
+                "Dominated actors: %zu\n",
+                in->pre.fixed_m, in->pre.dominated_m);
+    if (in->tt_bytes)
+        fprintf(stderr,
+                "Transposition hits: %u\n"
+                "Transposition misses: %u\n"
+                "Transposition evictions: %u\n",
+                ctx.tt.hits, ctx.tt.misses, ctx.tt.evictions);
+    if (in->has_warm_start) {
+        if (heuristic_P == UINT_MAX)
+            fputs("Heuristic value: none\n", stderr);
+        else
+            fprintf(stderr, "Heuristic value: %u\n",
+                    heuristic_P + in->pre.fixed_c);
+        fprintf(stderr, "Heuristic time: %.17G ms\n", heuristic_time);
+    }
+    if (stop != _BB_STOP_NONE) {
+        static const char *const reasons[] = {
+            [_BB_STOP_TIME] = "time limit",
+            [_BB_STOP_NODES] = "node limit",
+            [_BB_STOP_SIGNAL] = "signal",
+        };
+        const unsigned P = OPT_P(&ctx);
+        const unsigned LB = ctx.open_LB < P ? ctx.open_LB : P;
+        char LB_str[32];
+
+        fprintf(stderr,
+                "Stopped: %s\n"
+                "Lower bound: %s\n",
+                reasons[stop], _bb_value_str(LB_str, sizeof LB_str, in, LB));
+        if (P == UINT_MAX)
+            fputs("Gap: none\n", stderr);
+        else
+            fprintf(stderr, "Gap: %.2f%%\n",
+                    P + in->pre.fixed_c
+                        ? 100.0 * (P - LB) / (P + in->pre.fixed_c)
+                        : 0.0);
+    }
 
-    free(ctx.opt_X);
-    free(ctx.E);
-    free(ctx.F);
-    free(ctx.X);
-    free(ctx.lens_S);
+    _bb_ctx_cleanup(&ctx);
+    bb_bound_cleanup(&bound);
+    pthread_mutex_destroy(&opt.lock);
+    free(opt.X);
+    free(run.LB);
 }
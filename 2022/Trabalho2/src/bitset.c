@@ -0,0 +1,100 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bitset.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BITSET_HAS_AVX2
+#endif
+
+/**
+ * @brief Count the bits set in a single word
+ *
+ * @param x word
+ * @return amount of bits set
+ */
+static inline unsigned
+_bb_popcount64(uint64_t x)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+size_t
+bb_bitset_count(const uint64_t a[], size_t words)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < words; ++i)
+        total += _bb_popcount64(a[i]);
+    return total;
+}
+
+#ifdef BITSET_HAS_AVX2
+/**
+ * @brief AVX2 version of bb_bitset_union_count(), counts 256 bits at a time
+ *      with a nibble lookup table (`vpshufb`) and horizontal byte sums
+ *      (`vpsadbw`)
+ */
+__attribute__((target("avx2,popcnt"))) static size_t
+_bb_bitset_union_count_avx2(const uint64_t a[],
+                            const uint64_t b[],
+                            size_t words)
+{
+    const __m256i lookup =
+        _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    size_t total, i = 0;
+
+    for (; i + 4 <= words; i += 4) {
+        const __m256i v =
+            _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(a + i)),
+                            _mm256_loadu_si256((const __m256i *)(b + i)));
+        const __m256i lo = _mm256_and_si256(v, low_mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                            _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc,
+                               _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    total = (size_t)_mm256_extract_epi64(acc, 0)
+            + (size_t)_mm256_extract_epi64(acc, 1)
+            + (size_t)_mm256_extract_epi64(acc, 2)
+            + (size_t)_mm256_extract_epi64(acc, 3);
+    for (; i < words; ++i)
+        total += (size_t)__builtin_popcountll(a[i] | b[i]);
+    return total;
+}
+#endif /* BITSET_HAS_AVX2 */
+
+size_t
+bb_bitset_union_count(const uint64_t a[], const uint64_t b[], size_t words)
+{
+    size_t total = 0;
+
+#ifdef BITSET_HAS_AVX2
+    /* not worth the dispatch for less than a single 256-bit lane */
+    if (words >= 4 && __builtin_cpu_supports("avx2"))
+        return _bb_bitset_union_count_avx2(a, b, words);
+#endif
+    for (size_t i = 0; i < words; ++i)
+        total += _bb_popcount64(a[i] | b[i]);
+    return total;
+}
+
+bool
+bb_bitset_is_subset(const uint64_t a[], const uint64_t b[], size_t words)
+{
+    for (size_t i = 0; i < words; ++i)
+        if (a[i] & ~b[i]) return false;
+    return true;
+}
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bb.h"
+#include "bound.h"
+
+bool
+bb_bound_init(struct bb_bound *bound, const struct bb_input *in)
+{
+    /* cheapest costs seen so far, sorted (at most n of them) */
+    unsigned *cheapest = calloc(in->n + 1, sizeof *cheapest);
+    size_t count = 0;
+
+    *bound = (struct bb_bound){
+        .width = in->n + 1,
+        .sums = calloc((in->m + 1) * (in->n + 1), sizeof *bound->sums),
+        .last_S = calloc(in->l, sizeof *bound->last_S),
+    };
+    if (!cheapest || !bound->sums || !bound->last_S) {
+        perror("calloc()");
+        free(cheapest);
+        return false;
+    }
+
+    /* sweep suffixes from the shortest (empty) to the whole set, inserting
+     *      each actor's cost in order */
+    for (size_t j = in->m; j-- > 0;) {
+        unsigned *sums = BB_BOUND_SUMS(bound, j);
+        size_t pos = count < in->n ? count++ : in->n;
+
+        while (pos > 0 && cheapest[pos - 1] > in->A[j].c) {
+            if (pos < in->n) cheapest[pos] = cheapest[pos - 1];
+            --pos;
+        }
+        if (pos < in->n) cheapest[pos] = in->A[j].c;
+
+        for (size_t k = 0; k < count; ++k)
+            sums[k + 1] = sums[k] + cheapest[k];
+    }
+
+    for (size_t g = 0; g < in->l; ++g)
+        bound->last_S[g] = in->m;
+    for (size_t i = 0; i < in->m; ++i)
+        for (size_t j = 0; j < BB_SUB_SS(in, i); ++j)
+            bound->last_S[BB_SUB_S(in, i)[j] - 1] = i;
+
+    free(cheapest);
+    return true;
+}
+
+bool
+bb_bound_is_last(const struct bb_bound *bound,
+                 size_t l,
+                 const unsigned sub_S[],
+                 size_t sub_Ss,
+                 const unsigned cover_S[])
+{
+    for (size_t j = 0; j < sub_Ss; ++j)
+        if (cover_S[sub_S[j] - 1] == 0 && bound->last_S[sub_S[j] - 1] == l)
+            return true;
+    return false;
+}
+
+void
+bb_bound_cleanup(struct bb_bound *bound)
+{
+    free(bound->sums);
+    free(bound->last_S);
+}
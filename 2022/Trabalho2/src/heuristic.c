@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "bb.h"
+#include "bitset.h"
+#include "heuristic.h"
+
+/**
+ * @brief Add actor `i` to the cast
+ *
+ * @param in data parsed at input
+ * @param X current cast
+ * @param cover_S amount of cast actors covering each group
+ * @param i actor to be cast
+ * @return amount of groups newly covered
+ */
+static size_t
+_bb_heuristic_cast(const struct bb_input *in,
+                   unsigned X[],
+                   unsigned cover_S[],
+                   size_t i)
+{
+    const unsigned *sub_S = BB_SUB_S(in, i);
+    size_t covered = 0;
+
+    X[i] = true;
+    for (size_t j = 0; j < BB_SUB_SS(in, i); ++j)
+        if (cover_S[sub_S[j] - 1]++ == 0) ++covered;
+    return covered;
+}
+
+/**
+ * @brief Greedy cover by cost per newly covered group (or by most newly
+ *      covered groups, which spends less characters), completed with the
+ *      cheapest actors left
+ *
+ * @param in data parsed at input
+ * @param by_count whether to pick actors by most newly covered groups
+ * @param X stores the cast
+ * @param cover_S stores the amount of cast actors covering each group
+ * @return `true` if a feasible cast was found
+ */
+static bool
+_bb_heuristic_greedy(const struct bb_input *in,
+                     bool by_count,
+                     unsigned X[],
+                     unsigned cover_S[])
+{
+    size_t sub_Am = 0, sub_Sm = 0;
+
+    for (size_t i = 0; i < in->m; ++i)
+        X[i] = false;
+    for (size_t g = 0; g < in->l; ++g)
+        cover_S[g] = 0;
+
+    while (sub_Sm < in->l) {
+        size_t best = in->m, best_new = 0;
+
+        if (sub_Am == in->n) return false;
+        for (size_t i = 0; i < in->m; ++i) {
+            size_t new_S = 0;
+
+            if (X[i]) continue;
+            for (size_t j = 0; j < BB_SUB_SS(in, i); ++j)
+                if (cover_S[BB_SUB_S(in, i)[j] - 1] == 0) ++new_S;
+            if (new_S == 0) continue;
+            /* by_count: new_S > best_new, ties by c_i < c_best;
+             *      otherwise: c_i / new_S < c_best / best_new */
+            if (best == in->m
+                || (by_count
+                        ? new_S > best_new
+                              || (new_S == best_new
+                                  && in->A[i].c < in->A[best].c)
+                        : (unsigned long long)in->A[i].c * best_new
+                              < (unsigned long long)in->A[best].c * new_S))
+            {
+                best = i;
+                best_new = new_S;
+            }
+        }
+        if (best == in->m) return false;
+        sub_Sm += _bb_heuristic_cast(in, X, cover_S, best);
+        ++sub_Am;
+    }
+    for (; sub_Am < in->n; ++sub_Am) {
+        size_t best = in->m;
+
+        for (size_t i = 0; i < in->m; ++i)
+            if (!X[i] && (best == in->m || in->A[i].c < in->A[best].c))
+                best = i;
+        if (best == in->m) return false;
+        _bb_heuristic_cast(in, X, cover_S, best);
+    }
+    return true;
+}
+
+/**
+ * @brief Whether cast actor `out` can be replaced by actor `in_i` without
+ *      leaving a group uncovered
+ *
+ * @param in data parsed at input
+ * @param cover_S amount of cast actors covering each group
+ * @param out cast actor
+ * @param in_i actor not cast
+ * @return `true` if the swap keeps every group covered
+ */
+static bool
+_bb_heuristic_can_swap(const struct bb_input *in,
+                       const unsigned cover_S[],
+                       size_t out,
+                       size_t in_i)
+{
+    const unsigned *out_S = BB_SUB_S(in, out);
+
+    /* groups are distinct per actor (see bb_input_parse()), so a group
+     *      covered once is covered by `out` alone */
+    for (size_t j = 0; j < BB_SUB_SS(in, out); ++j) {
+        const unsigned g = out_S[j];
+
+        if (cover_S[g - 1] == 1 && !BB_BITSET_TEST(in->A[in_i].bits_S, g - 1))
+            return false;
+    }
+    return true;
+}
+
+unsigned
+bb_heuristic(const struct bb_input *in, unsigned X[])
+{
+    unsigned *cover_S = calloc(in->l ? in->l : 1, sizeof *cover_S);
+    unsigned P = 0;
+    bool improved = true;
+
+    if (!cover_S) {
+        perror("calloc()");
+        return UINT_MAX;
+    }
+    if (!_bb_heuristic_greedy(in, false, X, cover_S)
+        && !_bb_heuristic_greedy(in, true, X, cover_S))
+    {
+        free(cover_S);
+        return UINT_MAX;
+    }
+
+    /* first-improvement swaps of a cast actor for a cheaper one */
+    while (improved) {
+        improved = false;
+        for (size_t i = 0; i < in->m; ++i) {
+            if (!X[i]) continue;
+            for (size_t j = 0; j < in->m; ++j) {
+                if (X[j] || in->A[j].c >= in->A[i].c
+                    || !_bb_heuristic_can_swap(in, cover_S, i, j))
+                    continue;
+                X[i] = false;
+                for (size_t k = 0; k < BB_SUB_SS(in, i); ++k)
+                    --cover_S[BB_SUB_S(in, i)[k] - 1];
+                _bb_heuristic_cast(in, X, cover_S, j);
+                improved = true;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < in->m; ++i)
+        if (X[i]) P += in->A[i].c;
+    free(cover_S);
+    return P;
+}
@@ -1,68 +1,348 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
 
 #include "bb.h"
+#include "binary.h"
+#include "bitset.h"
+#include "scan.h"
 
-#define BUF_SIZE 1024
+/* binary instances store indexes as 32-bit integers, copied as is */
+_Static_assert(sizeof(unsigned) == sizeof(uint32_t),
+               "unsigned must be 32 bits wide");
 
-bool
-bb_input_parse(struct bb_input *in)
+/** @brief Round `size` up to a multiple of `align` */
+#define ALIGN_UP(size, align) (((size) + (align)-1) / (align) * (align))
+
+/** @brief Byte offsets of each array within @ref bb_input.arena */
+struct _bb_arena_layout {
+    /** offset of @ref bb_input.A */
+    size_t A;
+    /** offset of @ref bb_input.S_off */
+    size_t S_off;
+    /** offset of @ref bb_input.S_idx (the last array, as it grows while
+     *      parsing) */
+    size_t S_idx;
+};
+
+/**
+ * @brief Make room for `nnz` groups at the end of the arena
+ *
+ * @param in input being parsed
+ * @param layout arrays offsets within the arena
+ * @param capacity amount of groups that fit in the arena, updated
+ * @param nnz amount of groups needed
+ * @return a boolean for success
+ */
+static bool
+_bb_arena_reserve(struct bb_input *in,
+                  const struct _bb_arena_layout *layout,
+                  size_t *capacity,
+                  size_t nnz)
 {
-    char buf[BUF_SIZE];
-    size_t l, m, n;
+    size_t new_capacity = *capacity ? *capacity : 64;
+    void *tmp;
 
-    if (!fgets(buf, sizeof(buf), stdin)) {
-        perror("fgets()");
+    if (nnz <= *capacity) return true;
+    while (new_capacity < nnz) {
+        if (new_capacity
+            > (SIZE_MAX - layout->S_idx) / sizeof *in->S_idx / 2)
+        {
+            fputs("Too many groups at input\n", stderr);
+            return false;
+        }
+        new_capacity *= 2;
+    }
+    tmp = realloc(in->arena, layout->S_idx + new_capacity * sizeof *in->S_idx);
+    if (!tmp) {
+        perror("realloc()");
         return false;
     }
-    if (sscanf(buf, "%zu %zu %zu", &l, &m, &n) != 3) {
-        perror("sscanf()");
+    in->arena = tmp;
+    in->arena_size = layout->S_idx + new_capacity * sizeof *in->S_idx;
+    in->S_off = (size_t *)((char *)tmp + layout->S_off);
+    in->S_idx = (unsigned *)((char *)tmp + layout->S_idx);
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * @brief Allocate the arena for the bitsets, actors and offsets, leaving the
+ *      groups to be appended with _bb_arena_reserve()
+ *
+ * @param in stores the counts and the arena
+ * @param layout stores the arrays offsets within the arena
+ * @param l total amount of groups
+ * @param m total amount of actors
+ * @param n total amount of characters
+ * @return a boolean for success
+ */
+static bool
+_bb_arena_init(struct bb_input *in,
+               struct _bb_arena_layout *layout,
+               size_t l,
+               size_t m,
+               size_t n)
+{
+    const size_t words = BB_BITSET_WORDS(l);
+
+    if (m > SIZE_MAX / 2
+                / (words * sizeof *in->bits_S + sizeof *in->A
+                   + sizeof *in->S_off))
+    {
+        fputs("Too many actors at input\n", stderr);
         return false;
     }
-    *in = (struct bb_input){
-        .l = l,
-        .m = m,
-        .n = n,
-        .A = calloc(m, sizeof *in->A),
-    };
-    if (!in->A) {
+    *in = (struct bb_input){ .l = l, .m = m, .n = n, .words_S = words };
+
+    /* bitsets, actors and offsets have known sizes, groups are appended at
+     *      the end of the arena as they are read */
+    layout->A = ALIGN_UP(m * words * sizeof *in->bits_S,
+                         _Alignof(struct bb_actor));
+    layout->S_off =
+        ALIGN_UP(layout->A + m * sizeof *in->A, _Alignof(size_t));
+    layout->S_idx = ALIGN_UP(layout->S_off + (m + 1) * sizeof *in->S_off,
+                             _Alignof(unsigned));
+    if (!(in->arena = calloc(1, layout->S_idx))) {
         perror("calloc()");
         return false;
     }
+    in->arena_size = layout->S_idx;
+    in->S_off = (size_t *)((char *)in->arena + layout->S_off);
+    return true;
+}
+
+/**
+ * @brief Point the arrays into the arena, which no longer moves, and fill
+ *      each actor's groups bitset
+ * @note a group listed more than once by the same actor is kept only once,
+ *      as the heuristic and bounds count each actor's groups as distinct
+ *
+ * @param in input whose groups were all appended
+ * @param layout arrays offsets within the arena
+ */
+static void
+_bb_arena_finish(struct bb_input *in, const struct _bb_arena_layout *layout)
+{
+    size_t nnz = 0;
+
+    in->bits_S = in->arena;
+    in->A = (struct bb_actor *)((char *)in->arena + layout->A);
+    in->S_idx = (unsigned *)((char *)in->arena + layout->S_idx);
+    for (size_t i = 0; i < in->m; ++i) {
+        const size_t start = in->S_off[i], end = in->S_off[i + 1];
+
+        in->A[i].bits_S = in->bits_S + i * in->words_S;
+        in->S_off[i] = nnz;
+        for (size_t j = start; j < end; ++j) {
+            const unsigned g = in->S_idx[j];
+
+            if (BB_BITSET_TEST(in->A[i].bits_S, g - 1)) continue;
+            BB_BITSET_SET(in->A[i].bits_S, g - 1);
+            in->S_idx[nnz++] = g;
+        }
+    }
+    in->S_off[in->m] = nnz;
+}
+
+/**
+ * @brief Read a text instance
+ *
+ * @param in stores parsed input data
+ * @param sc scanner over the input
+ * @return a boolean for success
+ */
+static bool
+_bb_input_read(struct bb_input *in, struct bb_scan *sc)
+{
+    struct _bb_arena_layout layout;
+    unsigned long l, m, n;
+    size_t capacity = 0;
+
+    if (!bb_scan_ulong(sc, UINT_MAX, &l) || !bb_scan_ulong(sc, SIZE_MAX, &m)
+        || !bb_scan_ulong(sc, SIZE_MAX, &n))
+    {
+        fputs("Invalid header, expected 'l m n'\n", stderr);
+        return false;
+    }
+    if (!_bb_arena_init(in, &layout, l, m, n)) return false;
 
     for (size_t i = 0; i < m; ++i) {
-        unsigned c;
-        size_t s;
+        const size_t nnz = in->S_off[i];
+        unsigned long c, s;
 
-        if (!fgets(buf, sizeof(buf), stdin)) {
-            perror("fgets()");
+        if (!bb_scan_ulong(sc, UINT_MAX, &c)
+            || !bb_scan_ulong(sc, SIZE_MAX, &s))
+        {
+            fprintf(stderr,
+                    "Invalid cost or amount of groups for actor %zu\n",
+                    i + 1);
             return false;
         }
-        if (sscanf(buf, "%u %zu", &c, &s) != 2) {
-            perror("sscanf()");
+        if (s > SIZE_MAX - nnz) {
+            fputs("Too many groups at input\n", stderr);
             return false;
         }
-        in->A[i] = (struct bb_actor){
-            .c = c,
-            .s = s,
-            .sub_S = calloc(s, sizeof *in->A[i].sub_S),
-        };
-        if (!in->A[i].sub_S) {
-            perror("calloc()");
+        if (!_bb_arena_reserve(in, &layout, &capacity, nnz + s))
             return false;
-        }
-        for (size_t j = 0; j < in->A[i].s; ++j) {
-            if (!fgets(buf, sizeof(buf), stdin)) {
-                perror("fgets()");
+        ((struct bb_actor *)((char *)in->arena + layout.A))[i].c =
+            (unsigned)c;
+        for (size_t j = 0; j < s; ++j) {
+            unsigned long g;
+
+            if (!bb_scan_ulong(sc, l, &g) || g == 0) {
+                fprintf(stderr, "Invalid group for actor %zu\n", i + 1);
                 return false;
             }
-            in->A[i].sub_S[j] = (unsigned)strtoul(buf, NULL, 10);
+            in->S_idx[nnz + j] = (unsigned)g;
+        }
+        in->S_off[i + 1] = nnz + s;
+    }
+    if (!bb_scan_at_end(sc)) {
+        fputs("Unexpected data after the last actor\n", stderr);
+        return false;
+    }
+
+    _bb_arena_finish(in, &layout);
+    return true;
+}
+
+/**
+ * @brief Load a binary instance (see binary.h)
+ *
+ * @param in stores parsed input data
+ * @param sc scanner over the input
+ * @return a boolean for success
+ */
+static bool
+_bb_input_load(struct bb_input *in, struct bb_scan *sc)
+{
+    struct _bb_arena_layout layout;
+    struct bb_binary_header h;
+    const char *data, *costs, *groups;
+    size_t size, capacity = 0;
+
+    if (!(data = bb_scan_rest(sc, &size))) return false;
+    if (size < sizeof h) {
+        fputs("Truncated binary header\n", stderr);
+        return false;
+    }
+    memcpy(&h, data, sizeof h);
+    data += sizeof h;
+    size -= sizeof h;
+    if (h.version != BB_BINARY_VERSION || h.flags != 0) {
+        fprintf(stderr, "Unsupported binary version %" PRIu32 "\n",
+                h.version);
+        return false;
+    }
+    /* offsets take 8 bytes per actor plus one, costs and groups 4 each */
+    if (h.l > UINT_MAX || h.n > SIZE_MAX || size < 8
+        || h.m > (size - 8) / 12 || h.nnz > (size - 8 - 12 * h.m) / 4
+        || size != 8 + 12 * h.m + 4 * h.nnz)
+    {
+        fputs("Binary instance doesn't match its header\n", stderr);
+        return false;
+    }
+    costs = data + 8 * (h.m + 1);
+    groups = costs + 4 * h.m;
+
+    if (!_bb_arena_init(in, &layout, h.l, h.m, h.n)
+        || !_bb_arena_reserve(in, &layout, &capacity, h.nnz))
+        return false;
+    for (size_t i = 0; i <= in->m; ++i) {
+        uint64_t off;
+
+        memcpy(&off, data + 8 * i, sizeof off);
+        if (i == 0 ? off != 0 : off < in->S_off[i - 1] || off > h.nnz) {
+            fprintf(stderr, "Invalid groups offset for actor %zu\n", i + 1);
+            return false;
         }
+        in->S_off[i] = off;
+    }
+    if (in->S_off[in->m] != h.nnz) {
+        fputs("Binary instance doesn't match its header\n", stderr);
+        return false;
     }
+    for (size_t i = 0; i < in->m; ++i) {
+        uint32_t c;
+
+        memcpy(&c, costs + 4 * i, sizeof c);
+        ((struct bb_actor *)((char *)in->arena + layout.A))[i].c = c;
+    }
+    memcpy(in->S_idx, groups, h.nnz * sizeof *in->S_idx);
+    for (size_t i = 0; i < in->m; ++i)
+        for (size_t j = in->S_off[i]; j < in->S_off[i + 1]; ++j)
+            if (in->S_idx[j] == 0 || in->S_idx[j] > in->l) {
+                fprintf(stderr, "Invalid group for actor %zu\n", i + 1);
+                return false;
+            }
+
+    _bb_arena_finish(in, &layout);
     return true;
 }
 
+bool
+bb_input_parse(struct bb_input *in, const char *path)
+{
+    struct bb_scan sc;
+    bool ok = false;
+
+    *in = (struct bb_input){ 0 };
+    if (bb_scan_open(&sc, path)) {
+        if (bb_scan_peek(&sc, BB_BINARY_MAGIC, BB_BINARY_MAGIC_LEN))
+            ok = _bb_input_load(in, &sc);
+        else
+            ok = _bb_input_read(in, &sc);
+    }
+    bb_scan_close(&sc);
+    return ok;
+}
+
+bool
+bb_input_write(const struct bb_input *in, const char *path)
+{
+    const struct bb_binary_header h = { .magic = BB_BINARY_MAGIC,
+                                        .version = BB_BINARY_VERSION,
+                                        .l = in->l,
+                                        .m = in->m,
+                                        .n = in->n,
+                                        .nnz = in->S_off[in->m] };
+    FILE *fp = fopen(path, "wb");
+    bool ok = false;
+
+    if (!fp) {
+        perror(path);
+        return false;
+    }
+    if (fwrite(&h, sizeof h, 1, fp) != 1) goto _close;
+    for (size_t i = 0; i <= in->m; ++i) {
+        const uint64_t off = in->S_off[i];
+
+        if (fwrite(&off, sizeof off, 1, fp) != 1) goto _close;
+    }
+    for (size_t i = 0; i < in->m; ++i) {
+        const uint32_t c = in->A[i].c;
+
+        if (fwrite(&c, sizeof c, 1, fp) != 1) goto _close;
+    }
+    if (h.nnz
+        && fwrite(in->S_idx, sizeof *in->S_idx, h.nnz, fp) != h.nnz)
+        goto _close;
+    ok = true;
+
+_close:
+    if (!ok) perror("fwrite()");
+    if (fclose(fp) != 0 && ok) {
+        perror("fclose()");
+        ok = false;
+    }
+    return ok;
+}
+
 void
 bb_input_set(struct bb_input *in, bool feasibility_cuts, bool optimality_cuts)
 {
@@ -70,12 +350,44 @@ bb_input_set(struct bb_input *in, bool feasibility_cuts, bool optimality_cuts)
     in->has_optimality_cuts = optimality_cuts;
 }
 
+void
+bb_input_set_threads(struct bb_input *in, size_t threads, size_t split_depth)
+{
+    in->threads = threads;
+    in->split_depth = split_depth;
+}
+
+void
+bb_input_set_warm_start(struct bb_input *in, bool warm_start)
+{
+    in->has_warm_start = warm_start;
+}
+
+void
+bb_input_set_transpositions(struct bb_input *in, size_t tt_bytes)
+{
+    in->tt_bytes = tt_bytes;
+}
+
+void
+bb_input_set_limits(struct bb_input *in,
+                    double time_limit,
+                    unsigned long node_limit)
+{
+    in->time_limit = time_limit;
+    in->node_limit = node_limit;
+}
+
+void
+bb_input_set_progress(struct bb_input *in, double progress)
+{
+    in->progress = progress;
+}
+
 void
 bb_input_cleanup(struct bb_input *in)
 {
-    if (in->A) {
-        for (size_t i = 0; i < in->m; ++i)
-            if (in->A[i].sub_S) free(in->A[i].sub_S);
-        free(in->A);
-    }
+    free(in->arena);
+    free(in->pre.orig);
+    free(in->pre.fixed);
 }
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include <pthread.h>
+
+#include "pool.h"
+
+bool
+bb_pool_init(struct bb_pool *pool, size_t nworkers, size_t ntasks)
+{
+    size_t start = 0;
+
+    *pool = (struct bb_pool){
+        .nworkers = nworkers,
+        .deques = calloc(nworkers, sizeof *pool->deques),
+        .slots = calloc(ntasks ? ntasks : 1, sizeof *pool->slots),
+    };
+    if (!pool->deques || !pool->slots) {
+        perror("calloc()");
+        return false;
+    }
+    for (size_t i = 0; i < nworkers; ++i) {
+        struct bb_deque *dq = &pool->deques[i];
+
+        pthread_mutex_init(&dq->lock, NULL);
+        dq->tasks = pool->slots + start;
+        for (size_t task = i; task < ntasks; task += nworkers)
+            dq->tasks[dq->tail++] = task;
+        start += dq->tail;
+    }
+    return true;
+}
+
+bool
+bb_pool_take(struct bb_pool *pool, size_t worker, size_t *task)
+{
+    struct bb_deque *dq = &pool->deques[worker];
+    bool found = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail) {
+        *task = dq->tasks[dq->head++];
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    if (found) return true;
+
+    /* own deque is empty, steal the last task from someone else */
+    for (size_t i = 1; i < pool->nworkers && !found; ++i) {
+        dq = &pool->deques[(worker + i) % pool->nworkers];
+
+        pthread_mutex_lock(&dq->lock);
+        if (dq->head < dq->tail) {
+            *task = dq->tasks[--dq->tail];
+            found = true;
+        }
+        pthread_mutex_unlock(&dq->lock);
+    }
+    if (found)
+        atomic_fetch_add_explicit(&pool->steals, 1, memory_order_relaxed);
+    return found;
+}
+
+void
+bb_pool_pending(struct bb_pool *pool,
+                void (*fn)(size_t task, void *data),
+                void *data)
+{
+    for (size_t i = 0; i < pool->nworkers; ++i) {
+        struct bb_deque *dq = &pool->deques[i];
+
+        pthread_mutex_lock(&dq->lock);
+        for (size_t j = dq->head; j < dq->tail; ++j)
+            fn(dq->tasks[j], data);
+        pthread_mutex_unlock(&dq->lock);
+    }
+}
+
+void
+bb_pool_cleanup(struct bb_pool *pool)
+{
+    if (pool->deques) {
+        for (size_t i = 0; i < pool->nworkers; ++i)
+            pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques);
+    }
+    free(pool->slots);
+}
@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bb.h"
+#include "bitset.h"
+
+/** @brief Actor kept by the presolve, along with its original index */
+struct _bb_presolve_actor {
+    /** actor information */
+    struct bb_actor a;
+    /** index of the actor at input */
+    size_t orig;
+    /** start of the actor's renumbered groups */
+    size_t off;
+    /** amount of the actor's groups left uncovered */
+    size_t s;
+};
+
+/**
+ * @brief Whether actor `i` dominates actor `j`: it covers every group `j`
+ *      does, at lower or equal cost (identical actors are ranked by index,
+ *      so that only one of them dominates the other)
+ *
+ * @param in data parsed at input
+ * @param i dominating actor candidate
+ * @param j dominated actor candidate
+ * @return `true` if `i` dominates `j`
+ */
+static bool
+_bb_presolve_dominates(const struct bb_input *in, size_t i, size_t j)
+{
+    const struct bb_actor *a = &in->A[i], *b = &in->A[j];
+
+    if (a->c > b->c || !bb_bitset_is_subset(b->bits_S, a->bits_S, in->words_S))
+        return false;
+    if (a->c == b->c && bb_bitset_is_subset(a->bits_S, b->bits_S, in->words_S))
+        return i < j;
+    return true;
+}
+
+/**
+ * @brief Cast actor `i` for good, marking its groups as covered
+ *
+ * @param in data parsed at input
+ * @param alive actors not yet fixed or removed
+ * @param covered groups covered by fixed actors
+ * @param i actor to be fixed
+ */
+static void
+_bb_presolve_fix(struct bb_input *in, bool alive[], uint64_t covered[], size_t i)
+{
+    const struct bb_actor *a = &in->A[i];
+
+    alive[i] = false;
+    in->pre.fixed[in->pre.fixed_m++] = i;
+    in->pre.fixed_c += a->c;
+    --in->n;
+    for (size_t w = 0; w < in->words_S; ++w)
+        covered[w] |= a->bits_S[w];
+    /* covered groups are irrelevant for every remaining actor */
+    for (size_t k = 0; k < in->m; ++k)
+        if (alive[k])
+            for (size_t w = 0; w < in->words_S; ++w)
+                in->A[k].bits_S[w] &= ~covered[w];
+}
+
+/**
+ * @brief Sort actors from the cheapest to the most expensive per group
+ *      covered, then by most groups covered
+ */
+static int
+_bb_presolve_cmp(const void *p_a, const void *p_b)
+{
+    const struct _bb_presolve_actor *pa = p_a, *pb = p_b;
+    const struct bb_actor *a = &pa->a, *b = &pb->a;
+    /* compare c_a / s_a against c_b / s_b without dividing */
+    const unsigned long long ca_sb = (unsigned long long)a->c * pb->s,
+                             cb_sa = (unsigned long long)b->c * pa->s;
+
+    if (pa->s == 0 || pb->s == 0) {
+        if (pa->s != pb->s) return pa->s == 0 ? 1 : -1;
+        if (a->c != b->c) return a->c < b->c ? -1 : 1;
+    }
+    else if (ca_sb != cb_sa) {
+        return ca_sb < cb_sa ? -1 : 1;
+    }
+    if (pa->s != pb->s) return pa->s > pb->s ? -1 : 1;
+    return (pa->orig > pb->orig) - (pa->orig < pb->orig);
+}
+
+/**
+ * @brief Drop fixed and dominated actors, renumber the groups left
+ *      uncovered and reorder the remaining actors for branching
+ *
+ * @param in data parsed at input
+ * @param alive actors not yet fixed or removed
+ * @param covered groups covered by fixed actors
+ * @return a boolean for success
+ */
+static bool
+_bb_presolve_compact(struct bb_input *in,
+                     const bool alive[],
+                     const uint64_t covered[])
+{
+    size_t *group_id = calloc(in->l, sizeof *group_id), l = 0, m = 0;
+    struct _bb_presolve_actor *kept = calloc(in->m, sizeof *kept);
+    /* renumbered groups, copied back in the new actors order */
+    unsigned *S_idx = calloc(in->S_off[in->m] ? in->S_off[in->m] : 1,
+                             sizeof *S_idx);
+    size_t words, nnz = 0;
+
+    if (!group_id || !kept || !S_idx) {
+        perror("calloc()");
+        free(group_id);
+        free(kept);
+        free(S_idx);
+        return false;
+    }
+    for (size_t g = 0; g < in->l; ++g)
+        if (!BB_BITSET_TEST(covered, g)) group_id[g] = ++l;
+    words = BB_BITSET_WORDS(l);
+
+    for (size_t i = 0; i < in->m; ++i) {
+        const unsigned *sub_S = BB_SUB_S(in, i);
+        const size_t off = nnz;
+
+        if (!alive[i]) continue;
+        for (size_t j = 0; j < BB_SUB_SS(in, i); ++j)
+            if (group_id[sub_S[j] - 1])
+                S_idx[nnz++] = (unsigned)group_id[sub_S[j] - 1];
+        kept[m++] = (struct _bb_presolve_actor){
+            .a = in->A[i], .orig = i, .off = off, .s = nnz - off
+        };
+    }
+    free(group_id);
+
+    qsort(kept, m, sizeof *kept, &_bb_presolve_cmp);
+
+    /* every array shrinks, so the arena is rewritten in place */
+    memset(in->bits_S, 0, m * words * sizeof *in->bits_S);
+    in->S_off[0] = 0;
+    for (size_t i = 0; i < m; ++i) {
+        struct bb_actor *a = &in->A[i];
+
+        *a = kept[i].a;
+        in->pre.orig[i] = kept[i].orig;
+        in->S_off[i + 1] = in->S_off[i] + kept[i].s;
+        memcpy(BB_SUB_S(in, i), S_idx + kept[i].off,
+               kept[i].s * sizeof *S_idx);
+        a->bits_S = in->bits_S + i * words;
+        for (size_t j = 0; j < kept[i].s; ++j)
+            BB_BITSET_SET(a->bits_S, BB_SUB_S(in, i)[j] - 1);
+    }
+    free(kept);
+    free(S_idx);
+
+    in->l = l;
+    in->m = m;
+    in->words_S = words;
+    return true;
+}
+
+bool
+bb_presolve(struct bb_input *in)
+{
+    bool *alive = calloc(in->m, sizeof *alive), changed = true;
+    uint64_t *covered = calloc(in->words_S, sizeof *covered);
+    size_t *cover_count = calloc(in->l, sizeof *cover_count),
+           *cover_by = calloc(in->l, sizeof *cover_by);
+    bool ok = false;
+
+    in->pre.m = in->m;
+    in->pre.fixed = calloc(in->m, sizeof *in->pre.fixed);
+    in->pre.orig = calloc(in->m, sizeof *in->pre.orig);
+    if (!alive || !covered || !cover_count || !cover_by || !in->pre.fixed
+        || !in->pre.orig)
+    {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    for (size_t i = 0; i < in->m; ++i)
+        alive[i] = true;
+
+    while (changed && !in->pre.infeasible) {
+        changed = false;
+
+        /* an uncovered group with a single actor left forces its cast */
+        memset(cover_count, 0, in->l * sizeof *cover_count);
+        for (size_t i = 0; i < in->m; ++i) {
+            if (!alive[i]) continue;
+            for (size_t j = 0; j < BB_SUB_SS(in, i); ++j) {
+                const size_t g = BB_SUB_S(in, i)[j] - 1;
+                ++cover_count[g];
+                cover_by[g] = i;
+            }
+        }
+        for (size_t g = 0; g < in->l && !in->pre.infeasible; ++g) {
+            if (BB_BITSET_TEST(covered, g)) continue;
+
+            if (cover_count[g] == 0 || (cover_count[g] == 1 && in->n == 0)) {
+                in->pre.infeasible = true;
+            }
+            else if (cover_count[g] == 1 && alive[cover_by[g]]) {
+                _bb_presolve_fix(in, alive, covered, cover_by[g]);
+                changed = true;
+            }
+        }
+        if (in->pre.infeasible) break;
+
+        /* an actor dominated by at least n others can always be swapped
+         *      for one of them that is not cast */
+        for (size_t j = 0; j < in->m; ++j) {
+            size_t dominators = 0;
+
+            if (!alive[j]) continue;
+            for (size_t i = 0; i < in->m && dominators < in->n; ++i)
+                if (i != j && alive[i] && _bb_presolve_dominates(in, i, j))
+                    ++dominators;
+            if (dominators >= in->n) {
+                alive[j] = false;
+                ++in->pre.dominated_m;
+                changed = true;
+            }
+        }
+    }
+    ok = in->pre.infeasible || _bb_presolve_compact(in, alive, covered);
+
+_cleanup:
+    free(alive);
+    free(covered);
+    free(cover_count);
+    free(cover_by);
+    return ok;
+}
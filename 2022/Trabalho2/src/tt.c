@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tt.h"
+
+/**
+ * @brief Mix bits of a 64-bit value (splitmix64 finalizer)
+ *
+ * @param x value to be mixed
+ * @return mixed value
+ */
+static inline uint64_t
+_bb_tt_mix(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+bool
+bb_tt_init(struct bb_tt *tt, size_t bytes, size_t words)
+{
+    const size_t slot_size =
+        sizeof *tt->slots + (words ? words : 1) * sizeof *tt->keys_S;
+    size_t nslots = 1;
+
+    while (2 * nslots * slot_size <= bytes)
+        nslots *= 2;
+
+    *tt = (struct bb_tt){
+        .mask = nslots - 1,
+        .words = words,
+        .slots = calloc(nslots, sizeof *tt->slots),
+        .keys_S = calloc(nslots * (words ? words : 1), sizeof *tt->keys_S),
+    };
+    if (!tt->slots || !tt->keys_S) {
+        perror("calloc()");
+        return false;
+    }
+    return true;
+}
+
+bool
+bb_tt_probe(struct bb_tt *tt,
+            size_t l,
+            size_t Am,
+            const uint64_t bits_S[],
+            unsigned P)
+{
+    uint64_t hash = _bb_tt_mix(((uint64_t)l << 32) ^ Am);
+    struct bb_tt_slot *slot;
+    uint64_t *key_S;
+
+    for (size_t i = 0; i < tt->words; ++i)
+        hash = _bb_tt_mix(hash ^ bits_S[i]);
+    hash |= 1; // 0 is reserved for empty slots
+
+    slot = &tt->slots[hash & tt->mask];
+    key_S = tt->keys_S + (hash & tt->mask) * tt->words;
+    if (slot->hash == hash && slot->l == l && slot->Am == Am
+        && !memcmp(key_S, bits_S, tt->words * sizeof *bits_S))
+    {
+        if (slot->P <= P) {
+            ++tt->hits;
+            return true;
+        }
+        ++tt->misses;
+        slot->P = P;
+        return false;
+    }
+
+    ++tt->misses;
+    if (slot->hash != 0) ++tt->evictions;
+    *slot = (struct bb_tt_slot){
+        .hash = hash, .P = P, .l = (unsigned)l, .Am = (unsigned)Am
+    };
+    memcpy(key_S, bits_S, tt->words * sizeof *bits_S);
+    return false;
+}
+
+void
+bb_tt_cleanup(struct bb_tt *tt)
+{
+    free(tt->slots);
+    free(tt->keys_S);
+}
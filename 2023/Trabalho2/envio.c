@@ -1,61 +1,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <math.h>
+#include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "bb.h"
+#include "bound.h"
 
 /* alt bounding function provided at the README.pdf */
 static unsigned
-alt_bounding_fn(const struct bb_item E[],
-                const size_t En,
-                const struct bb_item F[],
-                const size_t Fn,
-                const unsigned C,
-                const unsigned k)
+alt_bounding_fn(const struct bb_node *node)
 {
-    (void)F;
-    (void)Fn;
-    float estimated_k = E[0].w;
-    for (size_t i = 1; i < En; ++i)
-        estimated_k += E[i].w;
-    estimated_k = ceil(estimated_k / C);
-    return (k > estimated_k) ? k : estimated_k;
+    /* without capacity only weightless items can be picked */
+    const unsigned long estimated_k =
+        node->C ? (node->E_w + node->C - 1) / node->C : 0;
+    return (node->k > estimated_k) ? node->k : estimated_k;
 }
 
-/* default bounding function (should be slight better than alt_bounding_fn in
- *      most cases) */
-static unsigned
-bounding_fn(const struct bb_item E[],
-            const size_t En,
-            const struct bb_item F[],
-            const size_t Fn,
-            const unsigned C,
-            const unsigned k)
-{
-    float estimated_Ek = E[0].w, estimated_Fk = F[0].w;
-
-    for (size_t i = 1; i < En; ++i)
-        estimated_Ek += E[i].w;
-    estimated_Ek = ceil(estimated_Ek / C);
-    if (k > estimated_Ek) estimated_Ek = k;
-
-    for (size_t i = 1; i < Fn; ++i)
-        estimated_Fk += F[i].w;
-    estimated_Fk = ceil(estimated_Fk / C);
-
-    return estimated_Ek + estimated_Fk;
-}
+/** @brief Bounding functions selectable with `-b` (see bound.h) */
+static const struct {
+    const char *name;
+    bb_fn fn;
+} bounds[] = {
+    { "continuous", &bb_bound_continuous },
+    { "l2", &bb_bound_l2 },
+    { "clique", &bb_bound_clique },
+    { "max", &bb_bound_max },
+};
 
 int
 main(int argc, char *argv[])
 {
-    bool feasibility_cuts = true, optimality_cuts = true;
+    bool feasibility_cuts = true, optimality_cuts = true, warm_start = true;
     struct bb_input in = { 0 };
-    bb_fn fn = &bounding_fn;
+    bool presolve = true;
+    size_t threads = 1, split_depth = 0;
+    enum bb_engine engine = BB_ENGINE_AUTO;
+    const char *binary_path = NULL;
+    enum bb_presolve_order order = BB_PRESOLVE_WEIGHT;
+    bb_fn fn = &bb_bound_max;
 
-    for (int opt; (opt = getopt(argc, argv, "foah")) != -1;) {
+    for (int opt; (opt = getopt(argc, argv, "foab:gp:j:d:e:w:h")) != -1;) {
         switch (opt) {
         case 'f':
             feasibility_cuts = false;
@@ -66,15 +52,79 @@ main(int argc, char *argv[])
         case 'a':
             fn = &alt_bounding_fn;
             break;
+        case 'g':
+            warm_start = false;
+            break;
+        case 'p':
+            presolve = true;
+            if (strcmp(optarg, "weight") == 0)
+                order = BB_PRESOLVE_WEIGHT;
+            else if (strcmp(optarg, "dsatur") == 0)
+                order = BB_PRESOLVE_DSATUR;
+            else if (strcmp(optarg, "none") == 0)
+                presolve = false;
+            else
+                goto _usage;
+            break;
+        case 'j':
+            threads = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            split_depth = strtoul(optarg, NULL, 10);
+            break;
+        case 'e':
+            if (strcmp(optarg, "auto") == 0)
+                engine = BB_ENGINE_AUTO;
+            else if (strcmp(optarg, "bb") == 0)
+                engine = BB_ENGINE_BB;
+            else if (strcmp(optarg, "dp") == 0)
+                engine = BB_ENGINE_DP;
+            else
+                goto _usage;
+            break;
+        case 'w':
+            binary_path = optarg;
+            break;
+        case 'b':
+            fn = NULL;
+            for (size_t i = 0; i < sizeof bounds / sizeof *bounds; ++i)
+                if (strcmp(optarg, bounds[i].name) == 0) fn = bounds[i].fn;
+            if (fn) break;
+            fprintf(stderr, "Unknown bound '%s'\n", optarg);
+            /* fall through */
         case 'h':
         default:
-            fprintf(stderr, "Usage ./%s [-f] [-o] [-a] [-h]\n", argv[0]);
+        _usage:
+            fprintf(stderr,
+                    "Usage ./%s [-f] [-o] [-a] "
+                    "[-b continuous|l2|clique|max] [-g] "
+                    "[-p weight|dsatur|none] [-j threads] [-d depth] "
+                    "[-e auto|bb|dp] [-w binary] [-h] [FILE]\n",
+                    argv[0]);
             return EXIT_FAILURE;
         }
     }
 
-    if (!bb_input_parse(&in)) return EXIT_FAILURE;
+    if (optind < argc - 1) goto _usage;
+    if (!bb_input_parse(&in, optind < argc ? argv[optind] : NULL)) {
+        bb_input_cleanup(&in);
+        return EXIT_FAILURE;
+    }
+    /* convert the instance instead of solving it */
+    if (binary_path) {
+        const bool ok = bb_input_write(&in, binary_path);
+
+        bb_input_cleanup(&in);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (presolve && !bb_presolve(&in, order)) {
+        bb_input_cleanup(&in);
+        return EXIT_FAILURE;
+    }
     bb_input_set(&in, feasibility_cuts, optimality_cuts);
+    bb_input_set_warm_start(&in, warm_start);
+    bb_input_set_threads(&in, threads, split_depth);
+    bb_input_set_engine(&in, engine);
 
     bb_solve(&in, fn);
 
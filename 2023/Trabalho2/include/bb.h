@@ -5,8 +5,6 @@
 struct bb_item {
     /** item weight (in kg) */
     unsigned w;
-    /** item restrictions (indexes) */
-    bool *restrictions;
 };
 
 /** @brief trip's item pairs restriction */
@@ -15,8 +13,72 @@ struct bb_pair {
     struct bb_item *a, *b;
 };
 
+/** @brief Storage formats for @ref bb_conflicts */
+enum bb_conflicts_format {
+    /** one packed bitset row per item, for dense graphs */
+    BB_CONFLICTS_BITSET,
+    /** sorted adjacency lists in compressed sparse row form, for sparse
+     *      graphs */
+    BB_CONFLICTS_CSR
+};
+
+/**
+ * @brief Conflict graph between items (pairs that can't share a trip)
+ * @see conflicts.h
+ */
+struct bb_conflicts {
+    /** storage format, picked by bb_conflicts_init() from the density */
+    enum bb_conflicts_format format;
+    /** amount of items */
+    size_t n;
+    /** amount of 64-bit words in each bitset row */
+    size_t words;
+    /** bitset rows (item `j` is bit `j` of row `i` if they conflict) */
+    uint64_t *rows;
+    /** start of each item's adjacency list at `adj`, plus the end of the
+     *      last */
+    size_t *off;
+    /** adjacency lists, sorted per item */
+    unsigned *adj;
+    /** memory taken by the storage, in bytes */
+    size_t bytes;
+};
+
+/** @brief Orders in which bb_presolve() lays out the items for branching */
+enum bb_presolve_order {
+    /** from the heaviest item to the lightest */
+    BB_PRESOLVE_WEIGHT,
+    /** DSatur-style, by most conflicts with the items already laid out */
+    BB_PRESOLVE_DSATUR
+};
+
+/** @brief Engines bb_solve() can search with */
+enum bb_engine {
+    /** dynamic programming for small inputs, branch and bound otherwise */
+    BB_ENGINE_AUTO,
+    /** branch and bound */
+    BB_ENGINE_BB,
+    /** dynamic programming over subsets of items (see dp.h) */
+    BB_ENGINE_DP
+};
+
+/**
+ * @brief Reductions applied by bb_presolve(), to map solutions back to the
+ *      input items
+ */
+struct bb_presolve {
+    /** amount of items at input */
+    size_t n;
+    /** input index of each remaining item (`NULL` if not presolved) */
+    size_t *orig;
+    /** input indexes of items fixed in trips of their own */
+    size_t *fixed;
+    /** amount of items fixed in trips of their own */
+    size_t fixed_m;
+};
+
 /**
- * @brief Parsed input from stdin
+ * @brief Parsed input
  * @see bb_input_parse()
  */
 struct bb_input {
@@ -28,28 +90,100 @@ struct bb_input {
     unsigned C;
     /** items set */
     struct bb_item *I;
+    /** amount of 64-bit words in each items bitset */
+    size_t words_I;
+    /** conflict graph from the P-set */
+    struct bb_conflicts conflicts;
     /** whether feasibility cuts are enabled */
     bool has_feasibility_cuts;
     /** whether optimality cuts are enabled */
     bool has_optimality_cuts;
+    /** whether the incumbent is seeded by bb_heuristic() */
+    bool has_warm_start;
+    /** amount of worker threads (`0` or `1` for a sequential search) */
+    size_t threads;
+    /** depth at which the tree is split among threads (`0` for automatic) */
+    size_t split_depth;
+    /** engine to search with */
+    enum bb_engine engine;
+    /** reductions applied by bb_presolve() */
+    struct bb_presolve pre;
 };
 
-/** @brief Helper-type for bounding function parameter */
-typedef unsigned (*bb_fn)(const struct bb_item E[],
-                          const size_t Em,
-                          const struct bb_item F[],
-                          const size_t Fm,
-                          const unsigned C,
-                          const unsigned k);
+/**
+ * @brief Read-only view of a search node, as seen by the bounding function
+ * @note picked items (E set) are the first `Em` items, not yet picked items
+ *      (F set) are the remaining `Fm`; their weights, the trips loads and
+ *      items are kept up to date as the search descends and backtracks
+ */
+struct bb_node {
+    /** data parsed at input */
+    const struct bb_input *in;
+    /** bounding tables computed before searching (see bound.h) */
+    const struct bb_bound *bound;
+    /** amount of picked items */
+    size_t Em;
+    /** total weight of picked items */
+    unsigned long E_w;
+    /** amount of not yet picked items */
+    size_t Fm;
+    /** total weight of not yet picked items */
+    unsigned long F_w;
+    /** maximum weight capacity */
+    unsigned C;
+    /** current amount of trips */
+    unsigned k;
+    /** accumulated weight of each of the `k` trips */
+    const unsigned long *loads;
+    /** items carried by each of the `k` trips, as bitsets of `words_I` words
+     *      each */
+    const uint64_t *trips_S;
+    /** scratch space for the bounding function (room for `Fm` weights) */
+    unsigned *scratch;
+};
+
+/**
+ * @brief Helper-type for bounding function parameter
+ *
+ * @param node node to be bounded
+ * @return lower bound for the amount of trips
+ */
+typedef unsigned (*bb_fn)(const struct bb_node *node);
 
 /**
  * @brief Parse and allocate resources from input
+ * @note either a text or a binary (see binary.h) instance, counts and item
+ *      indexes are validated and any malformed or missing value is reported
+ *      at stderr
  *
  * @param in stores parsed input data
+ * @param path file to be read, or `NULL` for stdin
+ * @return a boolean for success, either way a bb_input_cleanup() should be
+ *      called
+ */
+_Bool bb_input_parse(struct bb_input *in, const char *path);
+
+/**
+ * @brief Write the input in the binary format (see binary.h), which
+ *      bb_input_parse() tells apart from text by its magic number
+ * @note expects an input not yet presolved
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param path file to be written
+ * @return a boolean for success
+ */
+_Bool bb_input_write(const struct bb_input *in, const char *path);
+
+/**
+ * @brief Fix items that can't share a trip with any other item in trips of
+ *      their own, then reorder the remaining items for branching
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param order order of the remaining items
  * @return a boolean for success, either way a bb_input_cleanup() should be
  *      called
  */
-_Bool bb_input_parse(struct bb_input *in);
+_Bool bb_presolve(struct bb_input *in, enum bb_presolve_order order);
 
 /**
  * @brief Change input settings
@@ -62,6 +196,35 @@ void bb_input_set(struct bb_input *in,
                   bool feasibility_cuts,
                   bool optimality_cuts);
 
+/**
+ * @brief Change warm start settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param warm_start whether the incumbent is seeded by a First-Fit-Decreasing
+ *      and local search heuristic before searching
+ */
+void bb_input_set_warm_start(struct bb_input *in, bool warm_start);
+
+/**
+ * @brief Change parallel search settings
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param threads amount of worker threads (`1` for a sequential search)
+ * @param split_depth depth at which the tree is split into subproblems
+ *      for the workers (`0` picks one from the amount of threads)
+ */
+void bb_input_set_threads(struct bb_input *in,
+                          size_t threads,
+                          size_t split_depth);
+
+/**
+ * @brief Change the engine to search with
+ *
+ * @param in input initialized with bb_input_parse()
+ * @param engine engine to search with
+ */
+void bb_input_set_engine(struct bb_input *in, enum bb_engine engine);
+
 /**
  * @brief Cleanup the resources allocated for @ref bb_input
  *
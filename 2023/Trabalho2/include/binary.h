@@ -0,0 +1,38 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+/**
+ * @file binary.h
+ * @brief Binary instance format, an alternative to the text input that is
+ *      loaded without tokenizing
+ *
+ * Laid out in host byte order, each array right after the previous one:
+ * - @ref bb_binary_header
+ * - `n` item weights, as `uint32_t`
+ * - `p` conflict pairs, as two `uint32_t` item indexes (0-indexed) each
+ */
+
+/** @brief First bytes of a binary instance */
+#define BB_BINARY_MAGIC "ENVIOBIN"
+/** @brief Length of @ref BB_BINARY_MAGIC */
+#define BB_BINARY_MAGIC_LEN 8
+/** @brief Format version written (and the only one read) */
+#define BB_BINARY_VERSION 1
+
+/** @brief Header of a binary instance */
+struct bb_binary_header {
+    /** @ref BB_BINARY_MAGIC, without its null terminator */
+    char magic[BB_BINARY_MAGIC_LEN];
+    /** @ref BB_BINARY_VERSION (also tells the byte order apart) */
+    uint32_t version;
+    /** reserved, always `0` */
+    uint32_t flags;
+    /** amount of items */
+    uint64_t n;
+    /** amount of conflict pairs */
+    uint64_t p;
+    /** trip capacity */
+    uint64_t C;
+};
+
+#endif /* BINARY_H */
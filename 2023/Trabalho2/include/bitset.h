@@ -0,0 +1,38 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+/** @brief Amount of 64-bit words needed for a bitset of `n` bits */
+#define BB_BITSET_WORDS(n) (((n) + 63) / 64)
+/** @brief Set bit `i` of bitset `b` */
+#define BB_BITSET_SET(b, i) ((b)[(i) / 64] |= (uint64_t)1 << ((i) % 64))
+/** @brief Clear bit `i` of bitset `b` */
+#define BB_BITSET_CLEAR(b, i) ((b)[(i) / 64] &= ~((uint64_t)1 << ((i) % 64)))
+/** @brief Test bit `i` of bitset `b` */
+#define BB_BITSET_TEST(b, i) (((b)[(i) / 64] >> ((i) % 64)) & 1)
+
+/**
+ * @brief Whether two bitsets have a bit set in common (`a & b`)
+ *
+ * @param a first bitset
+ * @param b second bitset
+ * @param words amount of 64-bit words in both `a` and `b`
+ * @return `true` if `a & b` isn't empty
+ */
+_Bool bb_bitset_intersects(const uint64_t a[],
+                           const uint64_t b[],
+                           size_t words);
+
+/**
+ * @brief Count the bits set in the intersection of two bitsets (`a & b`),
+ *      without materializing it
+ *
+ * @param a first bitset
+ * @param b second bitset
+ * @param words amount of 64-bit words in both `a` and `b`
+ * @return amount of bits set in `a & b`
+ */
+size_t bb_bitset_intersection_count(const uint64_t a[],
+                                    const uint64_t b[],
+                                    size_t words);
+
+#endif /* BITSET_H */
@@ -0,0 +1,78 @@
+#ifndef BOUND_H
+#define BOUND_H
+
+/**
+ * @brief Tables shared by the bin-packing lower bounds, computed once
+ *      before searching
+ */
+struct bb_bound {
+    /** every item, from the heaviest to the lightest */
+    size_t *order;
+    /** heaviest weight among items `i .. n-1` (`n + 1` entries) */
+    unsigned *max_w;
+    /**
+     * items that pairwise can't share a trip (because of a conflict or
+     *      because they don't fit together), sorted by index
+     */
+    size_t *clique;
+    /** amount of items in `clique` */
+    size_t clique_m;
+};
+
+/**
+ * @brief Sort the items by weight and find a clique of pairwise
+ *      incompatible items, greedily
+ * @note the clique starts with every item heavier than half the capacity,
+ *      then takes items by decreasing amount of conflicts
+ *
+ * @param bound bounding tables to be initialized
+ * @param in data parsed at input
+ * @return a boolean for success, either way a bb_bound_cleanup() should be
+ *      called
+ */
+_Bool bb_bound_init(struct bb_bound *bound, const struct bb_input *in);
+
+/**
+ * @brief Continuous bound: open trips plus the new trips needed for the
+ *      weight that doesn't fit in their residual capacity
+ *
+ * @param node node to be bounded
+ * @return lower bound for the amount of trips
+ */
+unsigned bb_bound_continuous(const struct bb_node *node);
+
+/**
+ * @brief Martello-Toth L2 bound over the not yet picked items too heavy for
+ *      every open trip (which can only go in new trips), combined with the
+ *      continuous bound
+ *
+ * @param node node to be bounded
+ * @return lower bound for the amount of trips
+ */
+unsigned bb_bound_l2(const struct bb_node *node);
+
+/**
+ * @brief Clique bound: not yet picked items of the clique need pairwise
+ *      distinct trips, new ones if no open trip can take them
+ *
+ * @param node node to be bounded
+ * @return lower bound for the amount of trips
+ */
+unsigned bb_bound_clique(const struct bb_node *node);
+
+/**
+ * @brief Maximum of bb_bound_l2() and bb_bound_clique()
+ *
+ * @param node node to be bounded
+ * @return lower bound for the amount of trips
+ */
+unsigned bb_bound_max(const struct bb_node *node);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_bound
+ *
+ * @param bound bounding tables to be cleaned up
+ */
+void bb_bound_cleanup(struct bb_bound *bound);
+
+#endif /* BOUND_H */
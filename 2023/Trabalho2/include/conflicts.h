@@ -0,0 +1,84 @@
+#ifndef CONFLICTS_H
+#define CONFLICTS_H
+
+/**
+ * @brief Build the conflict graph from its pairs, picking the storage
+ *      format that takes less memory (see @ref bb_conflicts)
+ * @note self-conflicts are ignored and repeated pairs are kept once
+ *
+ * @param cf conflict graph to be initialized
+ * @param n amount of items
+ * @param pairs `2 * p` item indexes (0-indexed), each pair in a row
+ * @param p amount of pairs
+ * @return a boolean for success, either way a bb_conflicts_cleanup() should
+ *      be called
+ */
+_Bool bb_conflicts_init(struct bb_conflicts *cf,
+                        size_t n,
+                        const unsigned pairs[],
+                        size_t p);
+
+/**
+ * @brief Whether items `i` and `j` can't share a trip
+ *
+ * @param cf conflict graph initialized with bb_conflicts_init()
+ * @param i item i
+ * @param j item j
+ * @return `true` if `i` and `j` conflict
+ */
+_Bool bb_conflicts_has(const struct bb_conflicts *cf, size_t i, size_t j);
+
+/**
+ * @brief Whether item `i` conflicts with any item of a set
+ *
+ * @param cf conflict graph initialized with bb_conflicts_init()
+ * @param i item i
+ * @param set items bitset
+ * @return `true` if some item of `set` conflicts with `i`
+ */
+_Bool bb_conflicts_intersects(const struct bb_conflicts *cf,
+                              size_t i,
+                              const uint64_t set[]);
+
+/**
+ * @brief Count the items of a set that conflict with item `i`
+ *
+ * @param cf conflict graph initialized with bb_conflicts_init()
+ * @param i item i
+ * @param set items bitset
+ * @return amount of items of `set` conflicting with `i`
+ */
+size_t bb_conflicts_intersection_count(const struct bb_conflicts *cf,
+                                       size_t i,
+                                       const uint64_t set[]);
+
+/**
+ * @brief Amount of items conflicting with item `i`
+ *
+ * @param cf conflict graph initialized with bb_conflicts_init()
+ * @param i item i
+ * @return degree of `i` in the conflict graph
+ */
+size_t bb_conflicts_degree(const struct bb_conflicts *cf, size_t i);
+
+/**
+ * @brief List the items conflicting with item `i`
+ *
+ * @param cf conflict graph initialized with bb_conflicts_init()
+ * @param i item i
+ * @param out stores the conflicting items, in increasing order (room for
+ *      bb_conflicts_degree() entries)
+ * @return amount of conflicting items
+ */
+size_t bb_conflicts_neighbors(const struct bb_conflicts *cf,
+                              size_t i,
+                              unsigned out[]);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_conflicts
+ *
+ * @param cf conflict graph to be cleaned up
+ */
+void bb_conflicts_cleanup(struct bb_conflicts *cf);
+
+#endif /* CONFLICTS_H */
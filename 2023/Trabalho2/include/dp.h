@@ -0,0 +1,33 @@
+#ifndef DP_H
+#define DP_H
+
+/** @brief Largest amount of items for bb_dp(), picked automatically */
+#define BB_DP_N_MAX 20
+/** @brief Largest table for bb_dp() (one byte per subset of items) */
+#define BB_DP_BYTES_MAX ((size_t)1 << 26)
+
+/**
+ * @brief Whether bb_dp() can solve the input (and within the memory budget)
+ *
+ * @param in data parsed at input
+ * @param n_max largest amount of items allowed
+ * @return `true` if bb_dp() applies
+ */
+_Bool bb_dp_fits(const struct bb_input *in, size_t n_max);
+
+/**
+ * @brief Solve the transportation problem by dynamic programming over
+ *      subsets of items: the least trips for a subset either equal the
+ *      least trips for it without its first item, or one more, depending on
+ *      whether some trip with the first item leaves a subset packed in one
+ *      trip less
+ * @note expects bb_dp_fits()
+ *
+ * @param in data parsed at input
+ * @param X stores the trip of each item (`n` entries)
+ * @param states stores the amount of subsets solved
+ * @return the amount of trips, or `UINT_MAX` if an item doesn't fit alone
+ */
+unsigned bb_dp(const struct bb_input *in, unsigned X[], unsigned long *states);
+
+#endif /* DP_H */
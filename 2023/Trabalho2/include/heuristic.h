@@ -0,0 +1,19 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+/**
+ * @brief Build a feasible packing with First-Fit-Decreasing that respects
+ *      the pair restrictions, then try to empty the lightest trips by moving
+ *      their items to other trips (directly, or by swapping with an item that
+ *      moves to a third trip)
+ *
+ * @param in data parsed at input
+ * @param bound bounding tables initialized with bb_bound_init()
+ * @param X stores the trip of each item (`n` entries)
+ * @return the amount of trips, or `UINT_MAX` if an item doesn't fit alone
+ */
+unsigned bb_heuristic(const struct bb_input *in,
+                      const struct bb_bound *bound,
+                      unsigned X[]);
+
+#endif /* HEURISTIC_H */
@@ -0,0 +1,73 @@
+#ifndef POOL_H
+#define POOL_H
+
+/** @brief Per-worker deque of task indexes */
+struct bb_deque {
+    /** guards `head` and `tail` */
+    pthread_mutex_t lock;
+    /** tasks dealt to this worker */
+    size_t *tasks;
+    /** first task not yet taken (owner takes from here) */
+    size_t head;
+    /** one past the last task not yet taken (thieves take from here) */
+    size_t tail;
+};
+
+/**
+ * @brief Work-stealing pool over a fixed set of tasks `0 .. ntasks-1`
+ * @note tasks are dealt round-robin, so that every worker starts with one of
+ *      the earliest (most promising) tasks; each worker drains its own deque
+ *      in order and, once dry, steals from the back of the others'
+ */
+struct bb_pool {
+    /** amount of workers */
+    size_t nworkers;
+    /** one deque per worker */
+    struct bb_deque *deques;
+    /** storage for every deque's tasks */
+    size_t *slots;
+    /** total of tasks taken from another worker's deque */
+    _Atomic unsigned steals;
+};
+
+/**
+ * @brief Deal tasks among the workers' deques
+ *
+ * @param pool pool to be initialized
+ * @param nworkers amount of workers
+ * @param ntasks amount of tasks
+ * @return a boolean for success, either way a bb_pool_cleanup() should be
+ *      called
+ */
+_Bool bb_pool_init(struct bb_pool *pool, size_t nworkers, size_t ntasks);
+
+/**
+ * @brief Take the next task for a worker, stealing from another worker if
+ *      its own deque is empty
+ *
+ * @param pool pool initialized with bb_pool_init()
+ * @param worker worker index
+ * @param task stores the taken task index
+ * @return `true` if a task was taken, `false` once every deque is empty
+ */
+_Bool bb_pool_take(struct bb_pool *pool, size_t worker, size_t *task);
+
+/**
+ * @brief Visit every task not yet taken
+ *
+ * @param pool pool initialized with bb_pool_init()
+ * @param fn called once per pending task
+ * @param data user data passed to `fn`
+ */
+void bb_pool_pending(struct bb_pool *pool,
+                     void (*fn)(size_t task, void *data),
+                     void *data);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_pool
+ *
+ * @param pool pool to be cleaned up
+ */
+void bb_pool_cleanup(struct bb_pool *pool);
+
+#endif /* POOL_H */
@@ -0,0 +1,95 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+/** @brief Size of each read when the input can't be mapped */
+#define BB_SCAN_CHUNK ((size_t)1 << 20)
+/** @brief Longest token the scanner accepts (way past any 64-bit integer) */
+#define BB_SCAN_TOKEN_MAX 32
+
+/**
+ * @brief Tokenizer over an input file
+ * @note regular files are mapped whole and tokenized in place, anything else
+ *      (pipes, terminals) is read in chunks of @ref BB_SCAN_CHUNK bytes
+ */
+struct bb_scan {
+    /** file descriptor being read */
+    int fd;
+    /** whether `fd` was opened by bb_scan_open() */
+    _Bool owns_fd;
+    /** mapped file, or `NULL` if read in chunks */
+    void *map;
+    /** size of `map` */
+    size_t map_size;
+    /** chunk buffer, or `NULL` if mapped */
+    char *buf;
+    /** size of `buf` */
+    size_t buf_size;
+    /** next byte to be tokenized */
+    const char *cur;
+    /** one past the last byte available */
+    const char *end;
+    /** whether every byte of the file is available */
+    _Bool eof;
+};
+
+/**
+ * @brief Open an input file for tokenizing
+ *
+ * @param sc scanner to be initialized
+ * @param path file to be read, or `NULL` for stdin
+ * @return a boolean for success, either way a bb_scan_close() should be
+ *      called
+ */
+_Bool bb_scan_open(struct bb_scan *sc, const char *path);
+
+/**
+ * @brief Read the next unsigned decimal integer
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @param max largest value accepted
+ * @param value stores the integer read
+ * @return `true` if an integer up to `max` was read, `false` at the end of
+ *      the input, on a read error, a malformed token or a value past `max`
+ */
+_Bool bb_scan_ulong(struct bb_scan *sc,
+                    unsigned long max,
+                    unsigned long *value);
+
+/**
+ * @brief Whether the input left starts with `prefix` (nothing is consumed)
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @param prefix bytes to be compared
+ * @param size amount of bytes in `prefix`, up to @ref BB_SCAN_TOKEN_MAX
+ * @return `true` if the next `size` bytes match `prefix`
+ */
+_Bool bb_scan_peek(struct bb_scan *sc, const void *prefix, size_t size);
+
+/**
+ * @brief Take every byte left at the input at once
+ * @note mapped files are handed as is, otherwise the rest of the input is
+ *      read into the scanner's buffer, which grows as needed
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @param size stores the amount of bytes taken
+ * @return the bytes taken (valid until bb_scan_close()), or `NULL` on a read
+ *      error
+ */
+const void *bb_scan_rest(struct bb_scan *sc, size_t *size);
+
+/**
+ * @brief Whether only whitespace is left at the input
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @return `true` if the whole input was consumed
+ */
+_Bool bb_scan_at_end(struct bb_scan *sc);
+
+/**
+ * @brief Cleanup the resources allocated for @ref bb_scan
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ */
+void bb_scan_close(struct bb_scan *sc);
+
+#endif /* SCAN_H */
@@ -1,22 +1,104 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <limits.h>
 
 #include <errno.h>
+#include <pthread.h>
 #include <sys/time.h>
 
 #include "bb.h"
+#include "bitset.h"
+#include "conflicts.h"
+#include "bound.h"
+#include "heuristic.h"
+#include "pool.h"
+#include "dp.h"
+
+/** @brief Split depth picked when none is given, per worker thread */
+#define SPLIT_TASKS_PER_THREAD 16
+
+/** @brief Milliseconds elapsed between two `struct timeval` */
+#define ELAPSED_MS(t1, t2)                                                    \
+    (((t2).tv_sec - (t1).tv_sec) * 1000.0                                     \
+     + ((t2).tv_usec - (t1).tv_usec) / 1000.0)
+
+/**
+ * @brief Rank of a solution with `K` trips found by subproblem `task`
+ * @note ties are broken by the earliest subproblem (in depth-first order),
+ *      which is the solution a sequential search keeps, so that every
+ *      amount of threads prints the same solution
+ */
+#define OPT_RANK(K, task) (((uint64_t)(K) << 32) | (uint32_t)(task))
+
+/** @brief Best solution found so far, shared by every worker */
+struct _bb_opt {
+    /** OPT_RANK() of the current optimal solution */
+    _Atomic uint64_t rank;
+    /** current optimal solution set */
+    unsigned *X;
+    /** serializes updates to the optimal solution */
+    pthread_mutex_t lock;
+};
+
+/** @brief Current optimal rank, for pruning */
+#define OPT_RANK_LOAD(ctx)                                                    \
+    atomic_load_explicit(&(ctx)->opt->rank, memory_order_relaxed)
+/** @brief Current optimal amount of trips */
+#define OPT_K(ctx) ((unsigned)(OPT_RANK_LOAD(ctx) >> 32))
+
+/** @brief Subproblems obtained by splitting the tree at a fixed depth */
+struct _bb_tasks {
+    /** split depth (amount of picked items per subproblem) */
+    size_t depth;
+    /** amount of subproblems */
+    size_t count;
+    /** amount of subproblems that fit in `X` */
+    size_t capacity;
+    /** trips of the picked items, `depth` per subproblem */
+    unsigned *X;
+};
+
+/**
+ * @brief Candidates with up to this many entries are sorted in place by
+ *      insertion, larger ones by qsort()
+ */
+#define NEXT_SORT_INSERTION_MAX 16
+
+/** @brief Candidate trip for the item being picked */
+struct _bb_next {
+    /** trip */
+    unsigned choice;
+    /** lower bound of the child node */
+    unsigned bound;
+};
+
+/** @brief Node of the search path (one per depth) */
+struct _bb_frame {
+    /** start of the node's candidates at `ctx->next` */
+    size_t off;
+    /** amount of candidates */
+    size_t count;
+    /** next candidate to visit */
+    size_t i;
+    /** amount of trips when the node was entered */
+    unsigned k;
+};
 
 /** @brief "Global" references structure */
 struct _bb_ctx {
     /** bounding function */
     bb_fn B;
-    /** current optimal amount of trips */
-    unsigned opt_K;
-    /** current optimal solution set */
-    unsigned *opt_X;
+    /** current optimal amount of trips and solution (shared among
+     *      threads) */
+    struct _bb_opt *opt;
+    /** where subproblems are stored while splitting, `NULL` otherwise */
+    struct _bb_tasks *split;
+    /** subproblem being searched (`1`-indexed, in depth-first order) */
+    size_t task;
     /** current feasible solution */
     unsigned *X;
     /** choices set (from set I) */
@@ -27,59 +109,95 @@ struct _bb_ctx {
     unsigned optimality_cuts;
     /** total of feasibility cuts */
     unsigned feasibility_cuts;
-    /**
-     * @note helper buffer for _bb_Cl_compute()
-     * accumulated weight for each (current) trip
-     */
-    unsigned *acc_weights;
+    /** accumulated weight for each trip (kept up to date by _bb_X_set()) */
+    unsigned long *loads;
+    /** amount of trips over capacity (kept up to date by _bb_X_set()) */
+    size_t overloaded;
+    /** total weight of picked items (kept up to date by _bb_X_set()) */
+    unsigned long E_w;
+    /** current amount of trips (highest trip of picked items) */
+    unsigned k;
+    /** total weight of every item */
+    unsigned long W;
+    /** items carried by each trip, as bitsets (see BB_TRIP_S()) */
+    uint64_t *trips_S;
+    /** conflicting pairs sharing a trip (kept up to date by _bb_X_set()) */
+    size_t conflicts;
+    /** bounding tables, see bound.h (shared among threads) */
+    const struct bb_bound *bound;
+    /** scratch space for the bounding function */
+    unsigned *scratch;
+    /** search path, one frame per depth */
+    struct _bb_frame *frames;
+    /** candidates of every node in the search path */
+    struct _bb_next *next;
+    /** amount of candidates that fit in `next` */
+    size_t next_capacity;
 };
 
-/**
- * @brief Whether current item 'i' is restricted against item 'j'
- *
- * @param[in] in data parsed at input
- * @param[in] ctx "global" references
- * @param[in] i item i
- * @param[in] j item j
- * @return `true` if restricted items are in the same trip, `false` otherwise
- */
-#define HAS_CONFLICT(in, ctx, i, j)                                           \
-    ((ctx)->X[(i)] == (ctx)->X[(j)] && (in)->I[(i)].restrictions[(j)])
+/** @brief Items bitset of trip `t` (1-indexed) */
+#define BB_TRIP_S(in, ctx, t) ((ctx)->trips_S + ((t)-1) * (in)->words_I)
 
 /**
- * @brief Check if restrictions for completed feasible solutions are met
+ * @brief Set the trip for item `i`, updating the trips loads, items,
+ *      conflicts and picked weight incrementally
  *
  * @param in data parsed at input
  * @param ctx "global" references
- * @param k current amount of trips
- * @return `true` if restrictions are validated, `false` otherwise
+ * @param i item index
+ * @param trip trip carrying item `i` (`0` to unpick it)
  */
-static unsigned
-_bb_check_restrictions(const struct bb_input *in,
-                       const struct _bb_ctx *ctx,
-                       const unsigned k)
+static void
+_bb_X_set(const struct bb_input *in,
+          struct _bb_ctx *ctx,
+          size_t i,
+          unsigned trip)
 {
-    unsigned acc_weights[k]; ///< accumulated weights (per trip)
+    const unsigned w = in->I[i].w;
+
+    if (ctx->X[i] == trip) return;
+
+    if (ctx->X[i] != 0) {
+        unsigned long *load = &ctx->loads[ctx->X[i] - 1];
 
-    memset(acc_weights, 0, k * sizeof *acc_weights);
+        uint64_t *trip_S = BB_TRIP_S(in, ctx, ctx->X[i]);
 
-    // get each trip accumulated weight and restrictions
-    for (size_t i = 0; i < in->n; ++i) {
-        acc_weights[ctx->X[i] - 1] += in->I[i].w;
-        // check if restrictions for item 'i' are respected
-        for (size_t j = 0; j < i; ++j)
-            if (HAS_CONFLICT(in, ctx, i, j)) return false;
-        for (size_t j = i + 1; j < in->n; ++j)
-            if (HAS_CONFLICT(in, ctx, i, j)) return false;
+        if (*load > in->C && *load - w <= in->C) --ctx->overloaded;
+        *load -= w;
+        ctx->E_w -= w;
+        BB_BITSET_CLEAR(trip_S, i);
+        ctx->conflicts -=
+            bb_conflicts_intersection_count(&in->conflicts, i, trip_S);
     }
+    ctx->X[i] = trip;
+    if (trip != 0) {
+        unsigned long *load = &ctx->loads[trip - 1];
+        uint64_t *trip_S = BB_TRIP_S(in, ctx, trip);
 
-    for (size_t i = 0; i < k; ++i)
-        if (acc_weights[i] > in->C) return false;
-    return true;
+        if (*load <= in->C && *load + w > in->C) ++ctx->overloaded;
+        *load += w;
+        ctx->E_w += w;
+        ctx->conflicts +=
+            bb_conflicts_intersection_count(&in->conflicts, i, trip_S);
+        BB_BITSET_SET(trip_S, i);
+    }
 }
 
+/**
+ * @brief Check if restrictions for completed feasible solutions are met
+ * @note always the case with feasibility cuts, as _bb_Cl_compute() only
+ *      offers trips that can take the item
+ *
+ * @param ctx "global" references
+ * @return `true` if restrictions are validated, `false` otherwise
+ */
+#define RESTRICTIONS_MET(ctx) ((ctx)->overloaded == 0 && (ctx)->conflicts == 0)
+
 /**
  * @brief Compute the Cl (choices) set for the current iteration
+ * @note trips are interchangeable, so item `l` only goes into an already
+ *      open trip or into the next new one (`k + 1`): each partition of the
+ *      items is visited once, under canonical trip labels
  *
  * @param in data parsed at input
  * @param ctx "global" references
@@ -93,102 +211,239 @@ _bb_Cl_compute(const struct bb_input *in, struct _bb_ctx *ctx, const size_t l)
 
     if (l == in->n) return 0;
 
-    if (in->has_feasibility_cuts && l != 0) {
-        ++ctx->feasibility_cuts;
-        memset(ctx->acc_weights, 0, in->n * sizeof *ctx->acc_weights);
-        // get each trip accumulated weight
-        for (size_t i = 0; i < l; ++i)
-            ctx->acc_weights[ctx->X[i] - 1] += in->I[i].w;
-        // pick trips where weight won't be surpassed
-        for (size_t i = 0; i < l; ++i) {
-            if (in->I[l].w + ctx->acc_weights[i] > in->C) continue;
-            ctx->Cl[count++] = i + 1;
-        }
-        return count;
+    if (in->has_feasibility_cuts) ++ctx->feasibility_cuts;
+    for (unsigned t = 1; t <= ctx->k + 1; ++t) {
+        // pick trips where weight won't be surpassed, and without items
+        //      conflicting with item 'l'
+        if (in->has_feasibility_cuts
+            && (in->I[l].w + ctx->loads[t - 1] > in->C
+                || bb_conflicts_intersects(&in->conflicts, l,
+                                           BB_TRIP_S(in, ctx, t))))
+            continue;
+        ctx->Cl[count++] = t;
     }
-
-    for (size_t i = 0; i < in->n; ++i)
-        ctx->Cl[count++] = i + 1;
     return count;
 }
 
 /**
- * @brief Total amount of trips for currently picked items
+ * @brief Store the current feasible solution as the optimal one, unless
+ *      another thread has found a better solution meanwhile
  *
- * @param X current feasible solution
- * @param n current feasible solution size
- * @return total amount of trips
+ * @param in data parsed at input
+ * @param ctx "global" references
  */
-static unsigned
-_bb_get_trips_max(const unsigned X[], const size_t n)
+static void
+_bb_opt_update(const struct bb_input *in, struct _bb_ctx *ctx)
 {
-    unsigned k = X[0];
-    for (size_t i = 1; i < n; ++i)
-        if (X[i] > k) k = X[i];
-    return k;
+    const uint64_t rank = OPT_RANK(ctx->k, ctx->task);
+
+    pthread_mutex_lock(&ctx->opt->lock);
+    if (rank < OPT_RANK_LOAD(ctx)) {
+        for (size_t i = 0; i < in->n; ++i)
+            ctx->opt->X[i] = ctx->X[i];
+        atomic_store_explicit(&ctx->opt->rank, rank, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&ctx->opt->lock);
 }
 
-struct _bb_next {
-    unsigned choice;
-    unsigned bound;
-};
+/**
+ * @brief Store the current trips of the picked items as a new subproblem
+ *
+ * @param tasks subproblems set
+ * @param X current feasible solution
+ */
+static void
+_bb_tasks_push(struct _bb_tasks *tasks, const unsigned X[])
+{
+    if (tasks->count == tasks->capacity) {
+        const size_t capacity = tasks->capacity ? 2 * tasks->capacity : 64;
+        unsigned *tmp = realloc(tasks->X, capacity * tasks->depth * sizeof *tmp);
+
+        if (!tmp) {
+            perror("realloc()");
+            exit(EXIT_FAILURE);
+        }
+        tasks->X = tmp;
+        tasks->capacity = capacity;
+    }
+    memcpy(tasks->X + tasks->count * tasks->depth, X,
+           tasks->depth * sizeof *X);
+    ++tasks->count;
+}
 
 static int
-_bb_next_cmp(const void *a, const void *b)
+_bb_next_cmp(const void *p_a, const void *p_b)
+{
+    const struct _bb_next *a = p_a, *b = p_b;
+    return (a->bound > b->bound) - (a->bound < b->bound);
+}
+
+/**
+ * @brief Sort candidates from least to most trips
+ *
+ * @param next candidates
+ * @param count amount of candidates
+ */
+static void
+_bb_next_sort(struct _bb_next next[], size_t count)
+{
+    if (count > NEXT_SORT_INSERTION_MAX) {
+        qsort(next, count, sizeof *next, &_bb_next_cmp);
+        return;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        const struct _bb_next tmp = next[i];
+        size_t j = i;
+
+        for (; j > 0 && next[j - 1].bound > tmp.bound; --j)
+            next[j] = next[j - 1];
+        next[j] = tmp;
+    }
+}
+
+/**
+ * @brief Make room for `count` candidates at `ctx->next + off`
+ * @note only grows once the trips outnumber the slots reserved per item
+ *
+ * @param ctx "global" references
+ * @param off start of the candidates
+ * @param count amount of candidates
+ */
+static void
+_bb_next_reserve(struct _bb_ctx *ctx, size_t off, size_t count)
+{
+    struct _bb_next *tmp;
+    size_t capacity = ctx->next_capacity;
+
+    if (off + count <= capacity) return;
+    while (capacity < off + count)
+        capacity *= 2;
+    if (!(tmp = realloc(ctx->next, capacity * sizeof *tmp))) {
+        perror("realloc()");
+        exit(EXIT_FAILURE);
+    }
+    ctx->next = tmp;
+    ctx->next_capacity = capacity;
+}
+
+/**
+ * @brief Compute the candidates of the node at depth `l`, each child bounded
+ *      from its own trips (E = picked items, item l included; F = not yet
+ *      picked items), sorted from least to most trips
+ *
+ * @param in data parsed at input
+ * @param ctx "global" references
+ * @param l index of current x node
+ * @param f current node
+ */
+static void
+_bb_expand(const struct bb_input *in,
+           struct _bb_ctx *ctx,
+           size_t l,
+           struct _bb_frame *f)
 {
-    return ((struct _bb_next *)a)->bound - ((struct _bb_next *)b)->bound;
+    struct _bb_next *next;
+
+    if ((f->count = _bb_Cl_compute(in, ctx, l)) == 0) return;
+
+    _bb_next_reserve(ctx, f->off, f->count);
+    next = ctx->next + f->off;
+    for (size_t i = 0; i < f->count; ++i) {
+        struct bb_node node;
+
+        _bb_X_set(in, ctx, l, ctx->Cl[i]);
+        ctx->k = (ctx->Cl[i] > f->k) ? ctx->Cl[i] : f->k;
+        node = (struct bb_node){ .in = in,
+                                 .bound = ctx->bound,
+                                 .Em = l + 1,
+                                 .E_w = ctx->E_w,
+                                 .Fm = in->n - (l + 1),
+                                 .F_w = ctx->W - ctx->E_w,
+                                 .C = in->C,
+                                 .k = ctx->k,
+                                 .loads = ctx->loads,
+                                 .trips_S = ctx->trips_S,
+                                 .scratch = ctx->scratch };
+        next[i].choice = ctx->Cl[i];
+        next[i].bound = ctx->B(&node);
+    }
+    _bb_X_set(in, ctx, l, 0);
+    ctx->k = f->k;
+    _bb_next_sort(next, f->count);
 }
 
 /**
  * @brief Solve the transportation problem from `README.pdf` with the
  *      Branch and Bound method
+ * @note the search path is kept at `ctx->frames`, one frame per depth,
+ *      and each node's candidates are stacked at `ctx->next` right after
+ *      its parent's, so that no memory is taken per node
  *
  * @param in data parsed at input
  * @param ctx "global" references
- * @param l index of current x node
+ * @param root index of the subtree's root x node
  */
 static void
-_bb_solve(const struct bb_input *in, struct _bb_ctx *ctx, const size_t l)
+_bb_solve(const struct bb_input *in, struct _bb_ctx *ctx, const size_t root)
 {
-    const unsigned k = _bb_get_trips_max(ctx->X, in->n);
-    struct _bb_next next[in->n - 1];
-    size_t count;
+    size_t l = root;
+    bool enter = true;
 
-    ++ctx->visited_nodes;
+    for (;;) {
+        struct _bb_frame *f = &ctx->frames[l];
 
-    if (l == in->n && _bb_check_restrictions(in, ctx, k)) {
-        if (k < ctx->opt_K) {
-            ctx->opt_K = k;
-            for (size_t i = 0; i < in->n; ++i)
-                ctx->opt_X[i] = ctx->X[i];
+        if (enter) {
+            enter = false;
+            *f = (struct _bb_frame){
+                .off = (l == root) ? 0 : f[-1].off + f[-1].count,
+                .k = ctx->k,
+            };
+            if (ctx->split && l == ctx->split->depth) {
+                _bb_tasks_push(ctx->split, ctx->X);
+            }
+            else {
+                ++ctx->visited_nodes;
+                if (l == in->n && RESTRICTIONS_MET(ctx)
+                    && OPT_RANK(f->k, ctx->task) < OPT_RANK_LOAD(ctx))
+                    _bb_opt_update(in, ctx);
+                _bb_expand(in, ctx, l, f);
+            }
         }
-    }
 
-    if ((count = _bb_Cl_compute(in, ctx, l)) != 0) {
-        /* E = currently picked items; F = not yet picked items */
-        const unsigned En = l + 1, Fn = in->n - En;
-        const struct bb_item *E = in->I, *F = in->I + En;
-        /* get nextchoice and nextbounds */
-        for (size_t i = 0; i < count; ++i) {
-            next[i].choice = ctx->Cl[i];
-            next[i].bound = ctx->B(E, En, F, Fn, in->C, k);
+        if (f->i < f->count) {
+            const struct _bb_next *next = &ctx->next[f->off + f->i++];
+
+            /* not even a tie can rank better than the current optimum */
+            if (in->has_optimality_cuts
+                && OPT_RANK(next->bound, ctx->task) >= OPT_RANK_LOAD(ctx))
+            {
+                ++ctx->optimality_cuts;
+                f->i = f->count;
+            }
+            else {
+                _bb_X_set(in, ctx, l, next->choice);
+                ctx->k = (next->choice > f->k) ? next->choice : f->k;
+                ++l;
+                enter = true;
+                continue;
+            }
         }
-        /* sort choice from least to most trips */
-        qsort(next, count, sizeof *next, &_bb_next_cmp);
-    }
 
-    for (size_t i = 0; i < count; ++i) {
-        if (in->has_optimality_cuts && next[i].bound >= ctx->opt_K) {
-            ++ctx->optimality_cuts;
-            return;
+        /* backtrack, so that a node's state only depends on its own
+         *      choices */
+        if (f->count != 0) {
+            _bb_X_set(in, ctx, l, 0);
+            ctx->k = f->k;
         }
-        ctx->X[l] = next[i].choice;
-        _bb_solve(in, ctx, l + 1);
+        if (l == root) break;
+        --l;
     }
 }
 
 /**
- * @brief Prints the encountered optimal solution
+ * @brief Prints the encountered optimal solution, in the input items order
+ * @note items fixed by bb_presolve() take the trips after the searched ones,
+ *      then trips are numbered by their first item
  *
  * @param in data parsed at input
  * @param ctx "global" references
@@ -196,53 +451,305 @@ _bb_solve(const struct bb_input *in, struct _bb_ctx *ctx, const size_t l)
 static void
 _bb_solution_print(const struct bb_input *in, const struct _bb_ctx *ctx)
 {
-    if (ctx->opt_K == UINT_MAX) {
+    const size_t n = in->pre.orig ? in->pre.n : in->n;
+    const unsigned opt_K = OPT_K(ctx), K = opt_K + (unsigned)in->pre.fixed_m;
+    unsigned *trip, *label, k = 0;
+
+    if (opt_K == UINT_MAX) {
         puts("Inviável");
         return;
     }
-    for (size_t i = 0; i < in->n - 1; ++i)
-        printf("%u ", ctx->opt_X[i]);
-    printf("%u\n", ctx->opt_X[in->n - 1]);
-    printf("%u\n", ctx->opt_K);
+    trip = calloc(n ? n : 1, sizeof *trip);
+    label = calloc(K + 1, sizeof *label);
+    if (!trip || !label) {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < in->n; ++i)
+        trip[in->pre.orig ? in->pre.orig[i] : i] = ctx->opt->X[i];
+    for (size_t j = 0; j < in->pre.fixed_m; ++j)
+        trip[in->pre.fixed[j]] = opt_K + (unsigned)j + 1;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (label[trip[i]] == 0) label[trip[i]] = ++k;
+        printf(i + 1 < n ? "%u " : "%u", label[trip[i]]);
+    }
+    printf("\n%u\n", K);
+    free(trip);
+    free(label);
 }
 
-void
-bb_solve(const struct bb_input *in, const bb_fn fn_bounding)
+/**
+ * @brief Allocate a context's per-thread scratch and zero its state
+ *
+ * @param in data parsed at input
+ * @param ctx context to be initialized
+ * @param fn_bounding bounding function
+ * @param bound shared bounding tables
+ * @param opt shared optimal solution
+ */
+static void
+_bb_ctx_init(const struct bb_input *in,
+             struct _bb_ctx *ctx,
+             bb_fn fn_bounding,
+             const struct bb_bound *bound,
+             struct _bb_opt *opt)
 {
-    struct _bb_ctx ctx = {
+    *ctx = (struct _bb_ctx){
         .B = fn_bounding,
-        .opt_K = UINT_MAX,
-        .opt_X = calloc(in->n, sizeof *ctx.opt_X),
-        .X = calloc(in->n, sizeof *ctx.X),
-        .Cl = calloc(in->n, sizeof *ctx.Cl),
-        .acc_weights = calloc(in->n, sizeof *ctx.acc_weights),
+        .opt = opt,
+        .task = 1,
+        .X = calloc(in->n + 1, sizeof *ctx->X),
+        .Cl = calloc(in->n + 1, sizeof *ctx->Cl),
+        .loads = calloc(in->n + 1, sizeof *ctx->loads),
+        .trips_S = calloc((in->n + 1) * in->words_I, sizeof *ctx->trips_S),
+        .bound = bound,
+        .scratch = calloc(in->n + 1, sizeof *ctx->scratch),
+        .frames = calloc(in->n + 1, sizeof *ctx->frames),
+        /* a few trips per item, grown by _bb_next_reserve() if needed */
+        .next = calloc(4 * (in->n + 1), sizeof *ctx->next),
+        .next_capacity = 4 * (in->n + 1),
     };
+    if (!ctx->X || !ctx->Cl || !ctx->loads || !ctx->trips_S || !ctx->scratch
+        || !ctx->frames || !ctx->next)
+    {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < in->n; ++i)
+        ctx->W += in->I[i].w;
+}
+
+/**
+ * @brief Cleanup the resources allocated by _bb_ctx_init()
+ *
+ * @param ctx context to be cleaned up
+ */
+static void
+_bb_ctx_cleanup(struct _bb_ctx *ctx)
+{
+    free(ctx->X);
+    free(ctx->Cl);
+    free(ctx->loads);
+    free(ctx->trips_S);
+    free(ctx->scratch);
+    free(ctx->frames);
+    free(ctx->next);
+}
+
+/** @brief Worker thread of the parallel search */
+struct _bb_worker {
+    /** thread handle */
+    pthread_t tid;
+    /** worker index within the pool */
+    size_t id;
+    /** data parsed at input */
+    const struct bb_input *in;
+    /** subproblems to be solved */
+    const struct _bb_tasks *tasks;
+    /** work-stealing pool of `tasks` */
+    struct bb_pool *pool;
+    /** this worker's own references */
+    struct _bb_ctx ctx;
+};
+
+/**
+ * @brief Solve subproblems until there are none left to take or steal
+ *
+ * @param arg a @ref _bb_worker
+ * @return `NULL`
+ */
+static void *
+_bb_worker_run(void *arg)
+{
+    struct _bb_worker *w = arg;
+    const size_t depth = w->tasks->depth;
+    size_t task;
+
+    while (bb_pool_take(w->pool, w->id, &task)) {
+        const unsigned *X = w->tasks->X + task * depth;
+
+        /* undo the previous subproblem's choices, then replay this one's */
+        for (size_t i = depth; i-- > 0;)
+            _bb_X_set(w->in, &w->ctx, i, 0);
+        w->ctx.k = 0;
+        for (size_t i = 0; i < depth; ++i) {
+            _bb_X_set(w->in, &w->ctx, i, X[i]);
+            if (X[i] > w->ctx.k) w->ctx.k = X[i];
+        }
+        w->ctx.task = task + 1;
+        _bb_solve(w->in, &w->ctx, depth);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Split the tree at `in->split_depth` and solve the subproblems
+ *      with `in->threads` workers, adding their counters to `ctx`
+ *
+ * @param in data parsed at input
+ * @param ctx "global" references
+ * @param steals stores amount of subproblems stolen by idle workers
+ * @return amount of subproblems
+ */
+static size_t
+_bb_solve_parallel(const struct bb_input *in,
+                   struct _bb_ctx *ctx,
+                   unsigned *steals)
+{
+    struct _bb_tasks tasks = { .depth = in->split_depth };
+    struct _bb_worker *workers;
+    struct bb_pool pool;
+
+    if (tasks.depth == 0)
+        while (tasks.depth < in->n
+               && ((size_t)1 << tasks.depth)
+                      < SPLIT_TASKS_PER_THREAD * in->threads)
+            ++tasks.depth;
+    if (tasks.depth > in->n) tasks.depth = in->n;
+
+    /* nodes above the split depth are visited here */
+    ctx->split = &tasks;
+    _bb_solve(in, ctx, 0);
+    ctx->split = NULL;
+
+    if (!bb_pool_init(&pool, in->threads, tasks.count)) exit(EXIT_FAILURE);
+    if (!(workers = calloc(in->threads, sizeof *workers))) {
+        perror("calloc()");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < in->threads; ++i) {
+        struct _bb_worker *w = &workers[i];
+
+        *w = (struct _bb_worker){
+            .id = i, .in = in, .tasks = &tasks, .pool = &pool
+        };
+        _bb_ctx_init(in, &w->ctx, ctx->B, ctx->bound, ctx->opt);
+        if ((errno = pthread_create(&w->tid, NULL, &_bb_worker_run, w))) {
+            perror("pthread_create()");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (size_t i = 0; i < in->threads; ++i) {
+        struct _bb_worker *w = &workers[i];
+
+        pthread_join(w->tid, NULL);
+        ctx->visited_nodes += w->ctx.visited_nodes;
+        ctx->optimality_cuts += w->ctx.optimality_cuts;
+        ctx->feasibility_cuts += w->ctx.feasibility_cuts;
+        _bb_ctx_cleanup(&w->ctx);
+    }
+    *steals = atomic_load(&pool.steals);
+
+    free(workers);
+    bb_pool_cleanup(&pool);
+    free(tasks.X);
+
+    return tasks.count;
+}
+
+void
+bb_solve(const struct bb_input *in, const bb_fn fn_bounding)
+{
+    struct _bb_opt opt = { .rank = OPT_RANK(UINT_MAX, 0),
+                           .X = calloc(in->n + 1, sizeof *opt.X) };
+    struct bb_bound bound;
+    struct _bb_ctx ctx;
     struct timeval t1, t2;
-    double elapsed_time;
+    double elapsed_time, heuristic_time = 0;
+    unsigned heuristic_K = UINT_MAX, root_LB = 0, steals = 0;
+    unsigned long dp_states = 0;
+    size_t ntasks = 0;
+    bool use_dp = false;
 
-    if (!ctx.opt_X || !ctx.X || !ctx.Cl || !ctx.acc_weights) {
+    if (!opt.X) {
         perror("calloc()");
         exit(EXIT_FAILURE);
     }
+    if (!bb_bound_init(&bound, in)) exit(EXIT_FAILURE);
+    pthread_mutex_init(&opt.lock, NULL);
+    _bb_ctx_init(in, &ctx, fn_bounding, &bound, &opt);
+
+    switch (in->engine) {
+    case BB_ENGINE_DP:
+        use_dp = bb_dp_fits(in, SIZE_MAX);
+        if (!use_dp)
+            fputs("Too many items for the dp engine, using bb\n", stderr);
+        break;
+    case BB_ENGINE_AUTO:
+        use_dp = bb_dp_fits(in, BB_DP_N_MAX);
+        break;
+    case BB_ENGINE_BB:
+        break;
+    }
+
+    if (in->has_warm_start) {
+        /* root bound, no item picked yet */
+        const struct bb_node root = { .in = in,
+                                      .bound = &bound,
+                                      .Fm = in->n,
+                                      .F_w = ctx.W,
+                                      .C = in->C,
+                                      .loads = ctx.loads,
+                                      .trips_S = ctx.trips_S,
+                                      .scratch = ctx.scratch };
+
+        /* seed the incumbent, so that optimality cuts fire from the start */
+        gettimeofday(&t1, NULL);
+        heuristic_K = bb_heuristic(in, &bound, opt.X);
+        gettimeofday(&t2, NULL);
+        heuristic_time = ELAPSED_MS(t1, t2);
+        atomic_store(&opt.rank, OPT_RANK(heuristic_K, 0));
+        root_LB = ctx.B(&root);
+    }
 
     gettimeofday(&t1, NULL);
-    _bb_solve(in, &ctx, 0);
+    if (heuristic_K == root_LB)
+        ; // the heuristic packing is proven optimal, nothing to search
+    else if (use_dp)
+        atomic_store(&opt.rank, OPT_RANK(bb_dp(in, opt.X, &dp_states), 0));
+    else if (in->threads > 1)
+        ntasks = _bb_solve_parallel(in, &ctx, &steals);
+    else
+        _bb_solve(in, &ctx, 0);
     gettimeofday(&t2, NULL);
 
-    elapsed_time =
-        (t2.tv_sec - t1.tv_sec) * 1000.0 + (t2.tv_usec - t1.tv_usec) / 1000.0;
+    elapsed_time = ELAPSED_MS(t1, t2);
 
     _bb_solution_print(in, &ctx);
+    if (use_dp)
+        fprintf(stderr, "Engine: dp\nDP states: %lu\n", dp_states);
+    else
+        fputs("Engine: bb\n", stderr);
     fprintf(stderr,
             "Visited nodes: %u\n"
             "Elapsed time: %.17G ms\n"
             "Optimality cuts: %u\n"
-            "Feasibility cuts: %u\n",
+            "Feasibility cuts: %u\n"
+            "Conflicts storage: %s (%zu bytes)\n",
             ctx.visited_nodes, elapsed_time, ctx.optimality_cuts,
-            ctx.feasibility_cuts);
+            ctx.feasibility_cuts,
+            in->conflicts.format == BB_CONFLICTS_CSR ? "CSR" : "bitset",
+            in->conflicts.bytes);
+    if (in->threads > 1)
+        fprintf(stderr,
+                "Threads: %zu\n"
+                "Subproblems: %zu\n"
+                "Steals: %u\n",
+                in->threads, ntasks, steals);
+    if (in->pre.orig)
+        fprintf(stderr, "Fixed items: %zu\n", in->pre.fixed_m);
+    if (in->has_warm_start) {
+        if (heuristic_K == UINT_MAX)
+            fputs("Heuristic value: none\n", stderr);
+        else
+            fprintf(stderr, "Heuristic value: %zu\n",
+                    heuristic_K + in->pre.fixed_m);
+        fprintf(stderr, "Heuristic time: %.17G ms\n", heuristic_time);
+    }
 
-    free(ctx.opt_X);
-    free(ctx.X);
-    free(ctx.Cl);
-    free(ctx.acc_weights);
+    _bb_ctx_cleanup(&ctx);
+    bb_bound_cleanup(&bound);
+    pthread_mutex_destroy(&opt.lock);
+    free(opt.X);
 }
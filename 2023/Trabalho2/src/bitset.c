@@ -0,0 +1,24 @@
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bitset.h"
+
+bool
+bb_bitset_intersects(const uint64_t a[], const uint64_t b[], size_t words)
+{
+    for (size_t i = 0; i < words; ++i)
+        if (a[i] & b[i]) return true;
+    return false;
+}
+
+size_t
+bb_bitset_intersection_count(const uint64_t a[],
+                             const uint64_t b[],
+                             size_t words)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < words; ++i)
+        total += (size_t)__builtin_popcountll(a[i] & b[i]);
+    return total;
+}
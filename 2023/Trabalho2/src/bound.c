@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bb.h"
+#include "bound.h"
+#include "conflicts.h"
+
+/** @brief Item to be sorted by bb_bound_init() */
+struct _bb_bound_item {
+    /** item index */
+    size_t i;
+    /** primary sort key (larger first) */
+    size_t key;
+    /** item weight, secondary sort key (heavier first) */
+    unsigned w;
+};
+
+static int
+_bb_bound_item_cmp(const void *p_a, const void *p_b)
+{
+    const struct _bb_bound_item *a = p_a, *b = p_b;
+
+    if (a->key != b->key) return a->key > b->key ? -1 : 1;
+    if (a->w != b->w) return a->w > b->w ? -1 : 1;
+    return (a->i > b->i) - (a->i < b->i);
+}
+
+static int
+_bb_bound_index_cmp(const void *p_a, const void *p_b)
+{
+    const size_t a = *(const size_t *)p_a, b = *(const size_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Whether items `i` and `j` can't share a trip
+ *
+ * @param in data parsed at input
+ * @param i item i
+ * @param j item j
+ * @return `true` if they conflict or don't fit together
+ */
+static bool
+_bb_bound_incompatible(const struct bb_input *in, size_t i, size_t j)
+{
+    return (unsigned long)in->I[i].w + in->I[j].w > in->C
+           || bb_conflicts_has(&in->conflicts, i, j);
+}
+
+bool
+bb_bound_init(struct bb_bound *bound, const struct bb_input *in)
+{
+    struct _bb_bound_item *items = calloc(in->n ? in->n : 1, sizeof *items);
+
+    *bound = (struct bb_bound){
+        .order = calloc(in->n ? in->n : 1, sizeof *bound->order),
+        .max_w = calloc(in->n + 1, sizeof *bound->max_w),
+        .clique = calloc(in->n ? in->n : 1, sizeof *bound->clique),
+    };
+    if (!items || !bound->order || !bound->max_w || !bound->clique) {
+        perror("calloc()");
+        free(items);
+        return false;
+    }
+
+    for (size_t i = 0; i < in->n; ++i)
+        items[i] = (struct _bb_bound_item){ .i = i, .w = in->I[i].w };
+    qsort(items, in->n, sizeof *items, &_bb_bound_item_cmp);
+    for (size_t i = 0; i < in->n; ++i)
+        bound->order[i] = items[i].i;
+    for (size_t i = in->n; i-- > 0;)
+        bound->max_w[i] = (in->I[i].w > bound->max_w[i + 1])
+                              ? in->I[i].w
+                              : bound->max_w[i + 1];
+
+    /* items heavier than half the capacity are pairwise incompatible, try
+     *      the others from the most conflicting one */
+    for (size_t i = 0; i < in->n; ++i) {
+        const size_t j = items[i].i;
+
+        items[i].key = (2UL * in->I[j].w > in->C)
+                           ? in->n + 1
+                           : bb_conflicts_degree(&in->conflicts, j);
+    }
+    qsort(items, in->n, sizeof *items, &_bb_bound_item_cmp);
+    for (size_t i = 0; i < in->n; ++i) {
+        const size_t j = items[i].i;
+        bool fits = true;
+
+        for (size_t q = 0; q < bound->clique_m && fits; ++q)
+            fits = _bb_bound_incompatible(in, j, bound->clique[q]);
+        if (fits) bound->clique[bound->clique_m++] = j;
+    }
+    qsort(bound->clique, bound->clique_m, sizeof *bound->clique,
+          &_bb_bound_index_cmp);
+
+    free(items);
+    return true;
+}
+
+/**
+ * @brief Residual capacity of the open trips
+ *
+ * @param node node to be bounded
+ * @param max_res stores the largest residual capacity of a single trip
+ * @return total residual capacity
+ */
+static unsigned long
+_bb_bound_residual(const struct bb_node *node, unsigned long *max_res)
+{
+    unsigned long total = 0;
+
+    *max_res = 0;
+    for (size_t t = 0; t < node->k; ++t) {
+        const unsigned long res =
+            (node->loads[t] < node->C) ? node->C - node->loads[t] : 0;
+
+        total += res;
+        if (res > *max_res) *max_res = res;
+    }
+    return total;
+}
+
+/**
+ * @brief New trips needed for the not yet picked weight that doesn't fit
+ *      in the open trips' residual capacity
+ *
+ * @param node node to be bounded
+ * @param residual total residual capacity of the open trips
+ * @return lower bound for the amount of new trips
+ */
+static unsigned long
+_bb_bound_new_trips(const struct bb_node *node, unsigned long residual)
+{
+    /* without capacity no weight fits, which isn't bounded by weight */
+    if (node->F_w <= residual || node->C == 0) return 0;
+    return (node->F_w - residual + node->C - 1) / node->C;
+}
+
+unsigned
+bb_bound_continuous(const struct bb_node *node)
+{
+    unsigned long max_res;
+    const unsigned long residual = _bb_bound_residual(node, &max_res);
+
+    return node->k + _bb_bound_new_trips(node, residual);
+}
+
+/**
+ * @brief Martello-Toth L2 bound for packing a set of weights
+ * @note for each `a <= C/2`, items heavier than `C - a` or `C/2` need a trip
+ *      each, and items in `[a, C/2]` can only fill the space left by the
+ *      latter
+ *
+ * @param u weights, from the heaviest to the lightest
+ * @param count amount of weights
+ * @param C capacity
+ * @return lower bound for the amount of trips
+ */
+static unsigned long
+_bb_bound_l2_trips(const unsigned u[], size_t count, unsigned C)
+{
+    size_t big = 0, j1 = 0, j3 = count;
+    unsigned long big_w = 0, j1_w = 0, j3_w = 0, best = 0, a = 0;
+
+    if (C == 0) return 0;
+    while (big < count && 2UL * u[big] > C)
+        big_w += u[big++];
+    for (size_t i = big; i < count; ++i)
+        j3_w += u[i];
+
+    for (;;) {
+        unsigned long residual, L;
+        size_t next;
+
+        /* J3 = [big, j3): items weighing at least a */
+        while (j3 > big && u[j3 - 1] < a)
+            j3_w -= u[--j3];
+        /* J1 = [0, j1): items heavier than C - a */
+        while (j1 < big && u[j1] > C - a)
+            j1_w += u[j1++];
+        /* J2 = [j1, big): the space they leave is all J3 can use */
+        residual = (big - j1) * (unsigned long)C - (big_w - j1_w);
+        L = big + ((j3_w > residual) ? (j3_w - residual + C - 1) / C : 0);
+        if (L > best) best = L;
+
+        /* next a is the next distinct weight among J3 */
+        for (next = j3; next > big && u[next - 1] <= a; --next)
+            continue;
+        if (next == big) break;
+        a = u[next - 1];
+    }
+    return best;
+}
+
+unsigned
+bb_bound_l2(const struct bb_node *node)
+{
+    const struct bb_bound *bound = node->bound;
+    unsigned long max_res, new_trips, l2;
+    const unsigned long residual = _bb_bound_residual(node, &max_res);
+    size_t count = 0;
+
+    /* not yet picked items too heavy for every open trip */
+    if (bound->max_w[node->Em] > max_res)
+        for (size_t i = 0; i < node->in->n; ++i) {
+            const size_t j = bound->order[i];
+
+            if (j < node->Em) continue;
+            if (node->in->I[j].w <= max_res) break;
+            node->scratch[count++] = node->in->I[j].w;
+        }
+    new_trips = _bb_bound_new_trips(node, residual);
+    l2 = _bb_bound_l2_trips(node->scratch, count, node->C);
+    return node->k + ((l2 > new_trips) ? l2 : new_trips);
+}
+
+unsigned
+bb_bound_clique(const struct bb_node *node)
+{
+    const struct bb_input *in = node->in;
+    const struct bb_bound *bound = node->bound;
+    size_t picked = 0, left = 0, blocked = 0, free_trips;
+    unsigned long need;
+
+    for (size_t q = 0; q < bound->clique_m; ++q) {
+        const size_t u = bound->clique[q];
+        bool fits = false;
+
+        if (u < node->Em) {
+            ++picked;
+            continue;
+        }
+        ++left;
+        for (size_t t = 0; t < node->k && !fits; ++t)
+            fits = node->loads[t] + in->I[u].w <= node->C
+                   && !bb_conflicts_intersects(
+                       &in->conflicts, u, node->trips_S + t * in->words_I);
+        if (!fits) ++blocked;
+    }
+    /* picked clique items hold distinct trips, the others can only go in
+     *      the remaining open trips, or in new ones */
+    free_trips = (node->k > picked) ? node->k - picked : 0;
+    need = (left > free_trips) ? left - free_trips : 0;
+    if (blocked > need) need = blocked;
+    return node->k + need;
+}
+
+unsigned
+bb_bound_max(const struct bb_node *node)
+{
+    const unsigned l2 = bb_bound_l2(node), clique = bb_bound_clique(node);
+    return (l2 > clique) ? l2 : clique;
+}
+
+void
+bb_bound_cleanup(struct bb_bound *bound)
+{
+    free(bound->order);
+    free(bound->max_w);
+    free(bound->clique);
+}
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bb.h"
+#include "bitset.h"
+#include "conflicts.h"
+
+static int
+_bb_conflicts_cmp(const void *a, const void *b)
+{
+    const unsigned x = *(const unsigned *)a, y = *(const unsigned *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Store the conflict graph as packed bitset rows
+ *
+ * @param cf conflict graph
+ * @param pairs `2 * p` item indexes, each pair in a row
+ * @param p amount of pairs
+ * @return a boolean for success
+ */
+static bool
+_bb_conflicts_init_bitset(struct bb_conflicts *cf,
+                          const unsigned pairs[],
+                          size_t p)
+{
+    if (!(cf->rows = calloc(cf->n ? cf->n * cf->words : 1, sizeof *cf->rows)))
+    {
+        perror("calloc()");
+        return false;
+    }
+    for (size_t i = 0; i < p; ++i) {
+        const unsigned a = pairs[2 * i], b = pairs[2 * i + 1];
+
+        if (a == b) continue;
+        BB_BITSET_SET(cf->rows + a * cf->words, b);
+        BB_BITSET_SET(cf->rows + b * cf->words, a);
+    }
+    cf->bytes = cf->n * cf->words * sizeof *cf->rows;
+    return true;
+}
+
+/**
+ * @brief Store the conflict graph as sorted adjacency lists in compressed
+ *      sparse row form
+ *
+ * @param cf conflict graph
+ * @param pairs `2 * p` item indexes, each pair in a row
+ * @param p amount of pairs
+ * @return a boolean for success
+ */
+static bool
+_bb_conflicts_init_csr(struct bb_conflicts *cf,
+                       const unsigned pairs[],
+                       size_t p)
+{
+    size_t *pos, nnz = 0;
+
+    cf->off = calloc(cf->n + 1, sizeof *cf->off);
+    cf->adj = calloc(p ? 2 * p : 1, sizeof *cf->adj);
+    if (!cf->off || !cf->adj || !(pos = calloc(cf->n + 1, sizeof *pos))) {
+        perror("calloc()");
+        return false;
+    }
+    for (size_t i = 0; i < p; ++i)
+        if (pairs[2 * i] != pairs[2 * i + 1]) {
+            ++cf->off[pairs[2 * i] + 1];
+            ++cf->off[pairs[2 * i + 1] + 1];
+        }
+    for (size_t i = 0; i < cf->n; ++i)
+        pos[i + 1] = cf->off[i + 1] += cf->off[i];
+    for (size_t i = 0; i < p; ++i) {
+        const unsigned a = pairs[2 * i], b = pairs[2 * i + 1];
+
+        if (a == b) continue;
+        cf->adj[pos[a]++] = b;
+        cf->adj[pos[b]++] = a;
+    }
+    free(pos);
+
+    /* sort each row and drop repeated pairs, compacting rows in place */
+    for (size_t i = 0, start = 0; i < cf->n; ++i) {
+        const size_t end = cf->off[i + 1];
+
+        qsort(cf->adj + start, end - start, sizeof *cf->adj,
+              &_bb_conflicts_cmp);
+        cf->off[i] = nnz;
+        for (size_t j = start; j < end; ++j)
+            if (j == start || cf->adj[j] != cf->adj[j - 1])
+                cf->adj[nnz++] = cf->adj[j];
+        start = end;
+    }
+    cf->off[cf->n] = nnz;
+    cf->bytes = (cf->n + 1) * sizeof *cf->off + nnz * sizeof *cf->adj;
+    return true;
+}
+
+bool
+bb_conflicts_init(struct bb_conflicts *cf,
+                  size_t n,
+                  const unsigned pairs[],
+                  size_t p)
+{
+    const size_t words = BB_BITSET_WORDS(n);
+    const double bitset_bytes = (double)n * words * sizeof *cf->rows,
+                 csr_bytes = (double)(n + 1) * sizeof *cf->off
+                             + 2.0 * p * sizeof *cf->adj;
+
+    *cf = (struct bb_conflicts){
+        .format = (csr_bytes < bitset_bytes) ? BB_CONFLICTS_CSR
+                                             : BB_CONFLICTS_BITSET,
+        .n = n,
+        .words = words,
+    };
+    if (cf->format == BB_CONFLICTS_CSR)
+        return _bb_conflicts_init_csr(cf, pairs, p);
+    return _bb_conflicts_init_bitset(cf, pairs, p);
+}
+
+bool
+bb_conflicts_has(const struct bb_conflicts *cf, size_t i, size_t j)
+{
+    const unsigned key = (unsigned)j;
+
+    if (cf->format == BB_CONFLICTS_BITSET)
+        return BB_BITSET_TEST(cf->rows + i * cf->words, j);
+    return bsearch(&key, cf->adj + cf->off[i], cf->off[i + 1] - cf->off[i],
+                   sizeof *cf->adj, &_bb_conflicts_cmp)
+           != NULL;
+}
+
+bool
+bb_conflicts_intersects(const struct bb_conflicts *cf,
+                        size_t i,
+                        const uint64_t set[])
+{
+    if (cf->format == BB_CONFLICTS_BITSET)
+        return bb_bitset_intersects(cf->rows + i * cf->words, set,
+                                    cf->words);
+    for (size_t j = cf->off[i]; j < cf->off[i + 1]; ++j)
+        if (BB_BITSET_TEST(set, cf->adj[j])) return true;
+    return false;
+}
+
+size_t
+bb_conflicts_intersection_count(const struct bb_conflicts *cf,
+                                size_t i,
+                                const uint64_t set[])
+{
+    size_t total = 0;
+
+    if (cf->format == BB_CONFLICTS_BITSET)
+        return bb_bitset_intersection_count(cf->rows + i * cf->words, set,
+                                            cf->words);
+    for (size_t j = cf->off[i]; j < cf->off[i + 1]; ++j)
+        total += BB_BITSET_TEST(set, cf->adj[j]);
+    return total;
+}
+
+size_t
+bb_conflicts_degree(const struct bb_conflicts *cf, size_t i)
+{
+    if (cf->format == BB_CONFLICTS_BITSET)
+        return bb_bitset_intersection_count(cf->rows + i * cf->words,
+                                            cf->rows + i * cf->words,
+                                            cf->words);
+    return cf->off[i + 1] - cf->off[i];
+}
+
+size_t
+bb_conflicts_neighbors(const struct bb_conflicts *cf, size_t i, unsigned out[])
+{
+    size_t count = 0;
+
+    if (cf->format == BB_CONFLICTS_CSR) {
+        for (size_t j = cf->off[i]; j < cf->off[i + 1]; ++j)
+            out[count++] = cf->adj[j];
+        return count;
+    }
+    for (size_t w = 0; w < cf->words; ++w)
+        for (uint64_t bits = cf->rows[i * cf->words + w]; bits;
+             bits &= bits - 1)
+            out[count++] = (unsigned)(w * 64 + __builtin_ctzll(bits));
+    return count;
+}
+
+void
+bb_conflicts_cleanup(struct bb_conflicts *cf)
+{
+    free(cf->rows);
+    free(cf->off);
+    free(cf->adj);
+}
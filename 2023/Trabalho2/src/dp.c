@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "bb.h"
+#include "conflicts.h"
+#include "dp.h"
+
+/** @brief Tables for the dynamic programming over subsets of items */
+struct _bb_dp {
+    /** data parsed at input */
+    const struct bb_input *in;
+    /** items conflicting with each item, as bitmasks */
+    uint32_t *adj;
+    /** least amount of trips for each subset of items */
+    uint8_t *trips;
+    /** weight of each subset of the lower half of the items */
+    unsigned long *W_lo;
+    /** weight of each subset of the upper half of the items */
+    unsigned long *W_hi;
+    /** amount of items in the lower half */
+    unsigned half;
+};
+
+/**
+ * @brief Look for a trip (taking the items removed from `rest` so far) that
+ *      leaves a subset packed in at most `target` trips
+ * @note the least trips never grow as items are removed, so a branch stops
+ *      once even removing every candidate isn't enough
+ *
+ * @param dp dynamic programming tables
+ * @param rest items not in the trip
+ * @param cand items that may still join the trip (no conflicts with it)
+ * @param load weight of the trip
+ * @param target amount of trips to be reached
+ * @param found stores the items left out of the trip
+ * @return `true` if such a trip was found
+ */
+static bool
+_bb_dp_search(const struct _bb_dp *dp,
+              uint32_t rest,
+              uint32_t cand,
+              unsigned long load,
+              unsigned target,
+              uint32_t *found)
+{
+    if (dp->trips[rest] <= target) {
+        *found = rest;
+        return true;
+    }
+    if (dp->trips[rest & ~cand] > target) return false;
+
+    while (cand) {
+        const unsigned j = (unsigned)__builtin_ctz(cand);
+        const uint32_t bit = (uint32_t)1 << j;
+
+        cand &= ~bit;
+        if (load + dp->in->I[j].w > dp->in->C) continue;
+        if (_bb_dp_search(dp, rest & ~bit, cand & ~dp->adj[j],
+                          load + dp->in->I[j].w, target, found))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Trip with the first item of `mask` that leaves the rest packed in
+ *      `target` trips
+ *
+ * @param dp dynamic programming tables
+ * @param mask items to be packed
+ * @param target amount of trips for the items left out
+ * @param found stores the items left out of the trip
+ * @return `true` if such a trip was found
+ */
+static bool
+_bb_dp_first_trip(const struct _bb_dp *dp,
+                  uint32_t mask,
+                  unsigned target,
+                  uint32_t *found)
+{
+    const unsigned low = (unsigned)__builtin_ctz(mask);
+    const uint32_t rest = mask & (mask - 1);
+
+    return _bb_dp_search(dp, rest, rest & ~dp->adj[low], dp->in->I[low].w,
+                         target, found);
+}
+
+/**
+ * @brief Weight of a subset of items
+ *
+ * @param dp dynamic programming tables
+ * @param mask subset of items
+ * @return the sum of their weights
+ */
+static unsigned long
+_bb_dp_weight(const struct _bb_dp *dp, uint32_t mask)
+{
+    return dp->W_lo[mask & (((uint32_t)1 << dp->half) - 1)]
+           + dp->W_hi[mask >> dp->half];
+}
+
+/**
+ * @brief Fill the weight of every subset of `n` items, starting at `first`
+ *
+ * @param in data parsed at input
+ * @param W stores the weights (`2^n` entries)
+ * @param first first item
+ * @param n amount of items
+ */
+static void
+_bb_dp_weights(const struct bb_input *in,
+               unsigned long W[],
+               size_t first,
+               size_t n)
+{
+    W[0] = 0;
+    for (uint32_t mask = 1; mask < ((uint32_t)1 << n); ++mask)
+        W[mask] = W[mask & (mask - 1)]
+                  + in->I[first + (unsigned)__builtin_ctz(mask)].w;
+}
+
+bool
+bb_dp_fits(const struct bb_input *in, size_t n_max)
+{
+    return in->n <= n_max && in->n < 32
+           && ((size_t)1 << in->n) <= BB_DP_BYTES_MAX;
+}
+
+unsigned
+bb_dp(const struct bb_input *in, unsigned X[], unsigned long *states)
+{
+    const uint32_t full = (uint32_t)(((uint64_t)1 << in->n) - 1);
+    struct _bb_dp dp = {
+        .in = in,
+        .adj = calloc(in->n ? in->n : 1, sizeof *dp.adj),
+        .trips = calloc((size_t)full + 1, sizeof *dp.trips),
+        .half = (unsigned)in->n / 2,
+    };
+    unsigned *nbrs = calloc(in->n ? in->n : 1, sizeof *nbrs);
+    unsigned K = UINT_MAX;
+
+    dp.W_lo = calloc((size_t)1 << dp.half, sizeof *dp.W_lo);
+    dp.W_hi = calloc((size_t)1 << (in->n - dp.half), sizeof *dp.W_hi);
+    *states = 0;
+    if (!dp.adj || !dp.trips || !nbrs || !dp.W_lo || !dp.W_hi) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    for (size_t i = 0; i < in->n; ++i) {
+        const size_t degree = bb_conflicts_neighbors(&in->conflicts, i, nbrs);
+
+        if (in->I[i].w > in->C) goto _cleanup;
+        for (size_t j = 0; j < degree; ++j)
+            dp.adj[i] |= (uint32_t)1 << nbrs[j];
+    }
+    _bb_dp_weights(in, dp.W_lo, 0, dp.half);
+    _bb_dp_weights(in, dp.W_hi, dp.half, in->n - dp.half);
+
+    /* subsets only depend on smaller ones */
+    for (uint32_t mask = 1; mask <= full; ++mask) {
+        const unsigned d = dp.trips[mask & (mask - 1)];
+        uint32_t found;
+
+        /* d trips can't fit the subset's weight, no need to search */
+        if (d == 0 || _bb_dp_weight(&dp, mask) > (unsigned long)d * in->C
+            || !_bb_dp_first_trip(&dp, mask, d - 1, &found))
+        {
+            dp.trips[mask] = d + 1;
+        }
+        else {
+            dp.trips[mask] = d;
+        }
+    }
+    *states = full;
+
+    /* rebuild the trips, each with the first item left */
+    K = 0;
+    for (uint32_t mask = full, rest; mask != 0; mask = rest) {
+        _bb_dp_first_trip(&dp, mask, dp.trips[mask] - 1u, &rest);
+        ++K;
+        for (uint32_t trip = mask & ~rest; trip != 0; trip &= trip - 1)
+            X[__builtin_ctz(trip)] = K;
+    }
+
+_cleanup:
+    free(dp.adj);
+    free(dp.trips);
+    free(dp.W_lo);
+    free(dp.W_hi);
+    free(nbrs);
+    return K;
+}
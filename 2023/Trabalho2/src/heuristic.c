@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#include "bb.h"
+#include "bitset.h"
+#include "conflicts.h"
+#include "bound.h"
+#include "heuristic.h"
+
+/** @brief Rounds of trip emptying attempts */
+#define BB_HEURISTIC_ROUNDS 16
+/** @brief Item-trip checks allowed to the heuristic, once spent no more
+ *      trips are emptied (so that large instances get a quick warm start) */
+#define BB_HEURISTIC_CHECKS (1UL << 24)
+
+/** @brief Packing built by the heuristic */
+struct _bb_heuristic {
+    /** trip of each item (1-indexed) */
+    unsigned *X;
+    /** amount of trips */
+    unsigned k;
+    /** accumulated weight of each trip */
+    unsigned long *loads;
+    /** items carried by each trip, as bitsets */
+    uint64_t *trips_S;
+    /** items moved by the current emptying attempt, to undo it */
+    size_t *moved;
+    /** trips the moved items came from */
+    unsigned *moved_from;
+    /** amount of moves by the current emptying attempt */
+    size_t moved_m;
+    /** item-trip checks left (see @ref BB_HEURISTIC_CHECKS) */
+    unsigned long checks;
+};
+
+/** @brief Items bitset of trip `t` (1-indexed) */
+#define BB_HEURISTIC_S(in, h, t) ((h)->trips_S + ((t)-1) * (in)->words_I)
+
+/**
+ * @brief Move item `i` to trip `t`
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @param i item index
+ * @param t destination trip (`0` if `i` isn't in a trip yet)
+ */
+static void
+_bb_heuristic_move(const struct bb_input *in,
+                   struct _bb_heuristic *h,
+                   size_t i,
+                   unsigned t)
+{
+    if (h->X[i] != 0) {
+        h->loads[h->X[i] - 1] -= in->I[i].w;
+        BB_BITSET_CLEAR(BB_HEURISTIC_S(in, h, h->X[i]), i);
+    }
+    h->X[i] = t;
+    h->loads[t - 1] += in->I[i].w;
+    BB_BITSET_SET(BB_HEURISTIC_S(in, h, t), i);
+}
+
+/**
+ * @brief Whether item `i` can join trip `t`, if item `out` leaves it
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @param i item index
+ * @param t trip index
+ * @param out item leaving trip `t` (`in->n` if none)
+ * @return `true` if the weight and pair restrictions are kept
+ */
+static bool
+_bb_heuristic_fits(const struct bb_input *in,
+                   struct _bb_heuristic *h,
+                   size_t i,
+                   unsigned t,
+                   size_t out)
+{
+    unsigned long load = h->loads[t - 1] + in->I[i].w;
+    size_t conflicts;
+
+    if (h->checks) --h->checks;
+    if (out != in->n) load -= in->I[out].w;
+    if (load > in->C) return false;
+    conflicts = bb_conflicts_intersection_count(&in->conflicts, i,
+                                                BB_HEURISTIC_S(in, h, t));
+    if (out != in->n && bb_conflicts_has(&in->conflicts, i, out))
+        --conflicts;
+    return conflicts == 0;
+}
+
+/**
+ * @brief Move item `i` to trip `t`, logging the move so it can be undone
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @param i item index
+ * @param t destination trip
+ */
+static void
+_bb_heuristic_log_move(const struct bb_input *in,
+                       struct _bb_heuristic *h,
+                       size_t i,
+                       unsigned t)
+{
+    h->moved[h->moved_m] = i;
+    h->moved_from[h->moved_m++] = h->X[i];
+    _bb_heuristic_move(in, h, i, t);
+}
+
+/**
+ * @brief Relocate item `i` out of trip `T`: into any other trip, or into a
+ *      trip `U` after moving one of its items to a third trip `V`
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @param i item index
+ * @param T trip being emptied
+ * @return `true` if item `i` was relocated
+ */
+static bool
+_bb_heuristic_relocate(const struct bb_input *in,
+                       struct _bb_heuristic *h,
+                       size_t i,
+                       unsigned T)
+{
+    for (unsigned U = 1; U <= h->k; ++U)
+        if (U != T && _bb_heuristic_fits(in, h, i, U, in->n)) {
+            _bb_heuristic_log_move(in, h, i, U);
+            return true;
+        }
+    for (size_t j = 0; j < in->n && h->checks; ++j) {
+        const unsigned U = h->X[j];
+
+        if (U == T || !_bb_heuristic_fits(in, h, i, U, j)) continue;
+        for (unsigned V = 1; V <= h->k; ++V)
+            if (V != T && V != U && _bb_heuristic_fits(in, h, j, V, in->n)) {
+                _bb_heuristic_log_move(in, h, j, V);
+                _bb_heuristic_log_move(in, h, i, U);
+                return true;
+            }
+    }
+    return false;
+}
+
+/**
+ * @brief Try to move every item of trip `T` to the other trips, closing it
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @param T trip to be emptied
+ * @return `true` if trip `T` was closed, otherwise the packing is unchanged
+ */
+static bool
+_bb_heuristic_empty(const struct bb_input *in,
+                    struct _bb_heuristic *h,
+                    unsigned T)
+{
+    h->moved_m = 0;
+    for (size_t i = 0; i < in->n; ++i) {
+        if (h->X[i] != T) continue;
+        if (!_bb_heuristic_relocate(in, h, i, T)) {
+            while (h->moved_m > 0) {
+                --h->moved_m;
+                _bb_heuristic_move(in, h, h->moved[h->moved_m],
+                                   h->moved_from[h->moved_m]);
+            }
+            return false;
+        }
+    }
+
+    /* the last trip takes the emptied trip's label */
+    if (T != h->k) {
+        for (size_t i = 0; i < in->n; ++i)
+            if (h->X[i] == h->k) h->X[i] = T;
+        h->loads[T - 1] = h->loads[h->k - 1];
+        memcpy(BB_HEURISTIC_S(in, h, T), BB_HEURISTIC_S(in, h, h->k),
+               in->words_I * sizeof *h->trips_S);
+    }
+    h->loads[h->k - 1] = 0;
+    memset(BB_HEURISTIC_S(in, h, h->k), 0, in->words_I * sizeof *h->trips_S);
+    --h->k;
+    return true;
+}
+
+/**
+ * @brief Try to close one trip, from the lightest to the heaviest
+ *
+ * @param in data parsed at input
+ * @param h packing being built
+ * @return `true` if a trip was closed
+ */
+static bool
+_bb_heuristic_improve(const struct bb_input *in, struct _bb_heuristic *h)
+{
+    bool *tried, closed = false;
+
+    if (h->k == 0) return false;
+    if (!(tried = calloc(h->k, sizeof *tried))) {
+        perror("calloc()");
+        return false;
+    }
+    for (unsigned round = 0; round < h->k && !closed && h->checks; ++round) {
+        unsigned T = 0;
+
+        for (unsigned t = 1; t <= h->k; ++t)
+            if (!tried[t - 1] && (T == 0 || h->loads[t - 1] < h->loads[T - 1]))
+                T = t;
+        tried[T - 1] = true;
+        closed = _bb_heuristic_empty(in, h, T);
+    }
+    free(tried);
+    return closed;
+}
+
+unsigned
+bb_heuristic(const struct bb_input *in,
+             const struct bb_bound *bound,
+             unsigned X[])
+{
+    struct _bb_heuristic h = {
+        .X = calloc(in->n ? in->n : 1, sizeof *h.X),
+        .loads = calloc(in->n ? in->n : 1, sizeof *h.loads),
+        .trips_S = calloc(in->n ? in->n * in->words_I : 1, sizeof *h.trips_S),
+        .moved = calloc(in->n ? 2 * in->n : 1, sizeof *h.moved),
+        .moved_from = calloc(in->n ? 2 * in->n : 1, sizeof *h.moved_from),
+        .checks = BB_HEURISTIC_CHECKS,
+    };
+    unsigned k = UINT_MAX, *label = NULL;
+
+    if (!h.X || !h.loads || !h.trips_S || !h.moved || !h.moved_from) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+
+    /* first fit, from the heaviest item to the lightest */
+    for (size_t q = 0; q < in->n; ++q) {
+        const size_t i = bound->order[q];
+        unsigned t = 1;
+
+        if (in->I[i].w > in->C) goto _cleanup;
+        while (t <= h.k && !_bb_heuristic_fits(in, &h, i, t, in->n))
+            ++t;
+        if (t > h.k) ++h.k;
+        _bb_heuristic_move(in, &h, i, t);
+    }
+    for (unsigned round = 0; round < BB_HEURISTIC_ROUNDS; ++round)
+        if (!_bb_heuristic_improve(in, &h)) break;
+
+    /* number trips by their first item, as the search does */
+    if (!(label = calloc(h.k + 1, sizeof *label))) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    k = 0;
+    for (size_t i = 0; i < in->n; ++i) {
+        if (label[h.X[i]] == 0) label[h.X[i]] = ++k;
+        X[i] = label[h.X[i]];
+    }
+
+_cleanup:
+    free(h.X);
+    free(h.loads);
+    free(h.trips_S);
+    free(h.moved);
+    free(h.moved_from);
+    free(label);
+    return k;
+}
@@ -1,10 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
 
 #include "bb.h"
+#include "binary.h"
+#include "bitset.h"
+#include "conflicts.h"
+#include "scan.h"
 
-#define BUF_SIZE 1024
+/* binary instances store indexes as 32-bit integers, copied as is */
+_Static_assert(sizeof(unsigned) == sizeof(uint32_t),
+               "unsigned must be 32 bits wide");
 
 #ifndef _BB_DEBUG
 #define PRINT_DEBUG(in)
@@ -22,33 +32,67 @@ _bb_input_debug(const struct bb_input *in)
     for (size_t i = 0; i < in->n; ++i) {
         fprintf(stderr, "%zu: ", i);
         for (size_t j = 0; j < in->n - 1; ++j)
-            fprintf(stderr, "%u ", in->I[i].restrictions[j]);
-        fprintf(stderr, "%u\n", in->I[i].restrictions[in->n - 1]);
+            fprintf(stderr, "%u ",
+                    (unsigned)bb_conflicts_has(&in->conflicts, i, j));
+        fprintf(stderr, "%u\n",
+                (unsigned)bb_conflicts_has(&in->conflicts, i, in->n - 1));
     }
 }
 #define PRINT_DEBUG(in) _bb_input_debug(in)
 #endif
 
-bool
-bb_input_parse(struct bb_input *in)
+/**
+ * @brief Read an item index (`1 .. n` at input) of conflict pair `i`
+ *
+ * @param sc scanner over the input
+ * @param n amount of items
+ * @param i pair being read
+ * @param index stores the index, starting at `0`
+ * @return a boolean for success
+ */
+static bool
+_bb_input_item(struct bb_scan *sc, size_t n, size_t i, unsigned *index)
+{
+    unsigned long v;
+
+    if (!bb_scan_ulong(sc, n, &v) || v == 0) {
+        fprintf(stderr, "Invalid item for conflict pair %zu\n", i + 1);
+        return false;
+    }
+    *index = (unsigned)(v - 1);
+    return true;
+}
+
+/**
+ * @brief Read a text instance
+ *
+ * @param in stores parsed input data
+ * @param sc scanner over the input
+ * @return a boolean for success
+ */
+static bool
+_bb_input_read(struct bb_input *in, struct bb_scan *sc)
 {
-    char buf[BUF_SIZE], *ptr = buf;
-    size_t n, p;
-    unsigned C;
+    unsigned long n, p, C;
+    unsigned *pairs = NULL;
+    bool ok = false;
 
-    if (!fgets(buf, sizeof(buf), stdin)) {
-        perror("fgets()");
+    if (!bb_scan_ulong(sc, UINT_MAX, &n) || !bb_scan_ulong(sc, SIZE_MAX, &p)
+        || !bb_scan_ulong(sc, UINT_MAX, &C))
+    {
+        fputs("Invalid header, expected 'n p C'\n", stderr);
         return false;
     }
-    if (sscanf(buf, "%zu %zu %u", &n, &p, &C) != 3) {
-        perror("sscanf()");
+    if (p > SIZE_MAX / 2 / sizeof *pairs) {
+        fputs("Too many conflict pairs at input\n", stderr);
         return false;
     }
     *in = (struct bb_input){
         .n = n,
         .p = p,
-        .C = C,
-        .I = calloc(n, sizeof *in->I),
+        .C = (unsigned)C,
+        .I = calloc(n ? n : 1, sizeof *in->I),
+        .words_I = BB_BITSET_WORDS(n),
     };
     if (!in->I) {
         perror("calloc()");
@@ -56,35 +100,181 @@ bb_input_parse(struct bb_input *in)
     }
 
     /* fill I-set */
-    if (!fgets(buf, sizeof(buf), stdin)) {
-        perror("fgets()");
-        return false;
-    }
     for (size_t i = 0; i < n; ++i) {
-        in->I[i].w = (unsigned)strtoul(ptr, &ptr, 10);
-        in->I[i].restrictions = calloc(n, sizeof *in->I[i].restrictions);
+        unsigned long w;
+
+        if (!bb_scan_ulong(sc, UINT_MAX, &w)) {
+            fprintf(stderr, "Invalid weight for item %zu\n", i + 1);
+            return false;
+        }
+        in->I[i].w = (unsigned)w;
     }
 
     /* fill P-set (restrictions) */
+    if (!(pairs = calloc(p ? 2 * p : 1, sizeof *pairs))) {
+        perror("calloc()");
+        return false;
+    }
     for (size_t i = 0; i < p; ++i) {
-        unsigned a, b;
+        if (!_bb_input_item(sc, n, i, &pairs[2 * i])
+            || !_bb_input_item(sc, n, i, &pairs[2 * i + 1]))
+            goto _cleanup;
+    }
+    if (!bb_scan_at_end(sc)) {
+        fputs("Unexpected data after the conflict pairs\n", stderr);
+        goto _cleanup;
+    }
+    ok = bb_conflicts_init(&in->conflicts, n, pairs, p);
 
-        if (!fgets(buf, sizeof(buf), stdin)) {
-            perror("fgets()");
-            return false;
-        }
-        if (sscanf(buf, "%u %u", &a, &b) != 2) {
-            perror("sscanf()");
+_cleanup:
+    free(pairs);
+    return ok;
+}
+
+/**
+ * @brief Load a binary instance (see binary.h)
+ *
+ * @param in stores parsed input data
+ * @param sc scanner over the input
+ * @return a boolean for success
+ */
+static bool
+_bb_input_load(struct bb_input *in, struct bb_scan *sc)
+{
+    struct bb_binary_header h;
+    const char *data;
+    unsigned *pairs;
+    size_t size;
+    bool ok;
+
+    if (!(data = bb_scan_rest(sc, &size))) return false;
+    if (size < sizeof h) {
+        fputs("Truncated binary header\n", stderr);
+        return false;
+    }
+    memcpy(&h, data, sizeof h);
+    data += sizeof h;
+    size -= sizeof h;
+    if (h.version != BB_BINARY_VERSION || h.flags != 0) {
+        fprintf(stderr, "Unsupported binary version %" PRIu32 "\n",
+                h.version);
+        return false;
+    }
+    if (h.n > UINT_MAX || h.C > UINT_MAX || h.n > size / sizeof(uint32_t)
+        || h.p > (size - h.n * sizeof(uint32_t)) / (2 * sizeof(uint32_t))
+        || size != (h.n + 2 * h.p) * sizeof(uint32_t))
+    {
+        fputs("Binary instance doesn't match its header\n", stderr);
+        return false;
+    }
+    *in = (struct bb_input){
+        .n = h.n,
+        .p = h.p,
+        .C = (unsigned)h.C,
+        .I = calloc(h.n ? h.n : 1, sizeof *in->I),
+        .words_I = BB_BITSET_WORDS(h.n),
+    };
+    pairs = calloc(h.p ? 2 * h.p : 1, sizeof *pairs);
+    if (!in->I || !pairs) {
+        perror("calloc()");
+        free(pairs);
+        return false;
+    }
+
+    for (size_t i = 0; i < in->n; ++i) {
+        uint32_t w;
+
+        memcpy(&w, data + i * sizeof w, sizeof w);
+        in->I[i].w = w;
+    }
+    memcpy(pairs, data + in->n * sizeof(uint32_t), 2 * h.p * sizeof *pairs);
+    for (size_t i = 0; i < 2 * h.p; ++i)
+        if (pairs[i] >= in->n) {
+            fprintf(stderr, "Invalid item for conflict pair %zu\n",
+                    i / 2 + 1);
+            free(pairs);
             return false;
         }
-        in->I[a - 1].restrictions[b - 1] = in->I[b - 1].restrictions[a - 1] =
-            true;
+    ok = bb_conflicts_init(&in->conflicts, in->n, pairs, in->p);
+    free(pairs);
+    return ok;
+}
+
+bool
+bb_input_parse(struct bb_input *in, const char *path)
+{
+    struct bb_scan sc;
+    bool ok = false;
+
+    *in = (struct bb_input){ 0 };
+    if (bb_scan_open(&sc, path)) {
+        if (bb_scan_peek(&sc, BB_BINARY_MAGIC, BB_BINARY_MAGIC_LEN))
+            ok = _bb_input_load(in, &sc);
+        else
+            ok = _bb_input_read(in, &sc);
     }
+    bb_scan_close(&sc);
+    if (!ok) return false;
 
     PRINT_DEBUG(in);
     return true;
 }
 
+bool
+bb_input_write(const struct bb_input *in, const char *path)
+{
+    struct bb_binary_header h = { .magic = BB_BINARY_MAGIC,
+                                  .version = BB_BINARY_VERSION,
+                                  .n = in->n,
+                                  .C = in->C };
+    unsigned *nbrs = calloc(in->n ? in->n : 1, sizeof *nbrs);
+    FILE *fp = NULL;
+    bool ok = false;
+
+    if (!nbrs) {
+        perror("calloc()");
+        return false;
+    }
+    /* repeated pairs were merged while parsing, so count them again */
+    for (size_t i = 0; i < in->n; ++i) {
+        const size_t degree = bb_conflicts_neighbors(&in->conflicts, i, nbrs);
+
+        for (size_t j = 0; j < degree; ++j)
+            if (nbrs[j] > i) ++h.p;
+    }
+    if (!(fp = fopen(path, "wb"))) {
+        perror(path);
+        goto _cleanup;
+    }
+    if (fwrite(&h, sizeof h, 1, fp) != 1) goto _close;
+    for (size_t i = 0; i < in->n; ++i) {
+        const uint32_t w = in->I[i].w;
+
+        if (fwrite(&w, sizeof w, 1, fp) != 1) goto _close;
+    }
+    for (size_t i = 0; i < in->n; ++i) {
+        const size_t degree = bb_conflicts_neighbors(&in->conflicts, i, nbrs);
+
+        for (size_t j = 0; j < degree; ++j) {
+            const uint32_t pair[2] = { (uint32_t)i, nbrs[j] };
+
+            if (nbrs[j] > i && fwrite(pair, sizeof pair, 1, fp) != 1)
+                goto _close;
+        }
+    }
+    ok = true;
+
+_close:
+    if (!ok) perror("fwrite()");
+    if (fclose(fp) != 0 && ok) {
+        perror("fclose()");
+        ok = false;
+    }
+_cleanup:
+    free(nbrs);
+    return ok;
+}
+
 void
 bb_input_set(struct bb_input *in, bool feasibility_cuts, bool optimality_cuts)
 {
@@ -92,11 +282,30 @@ bb_input_set(struct bb_input *in, bool feasibility_cuts, bool optimality_cuts)
     in->has_optimality_cuts = optimality_cuts;
 }
 
+void
+bb_input_set_warm_start(struct bb_input *in, bool warm_start)
+{
+    in->has_warm_start = warm_start;
+}
+
+void
+bb_input_set_threads(struct bb_input *in, size_t threads, size_t split_depth)
+{
+    in->threads = threads;
+    in->split_depth = split_depth;
+}
+
+void
+bb_input_set_engine(struct bb_input *in, enum bb_engine engine)
+{
+    in->engine = engine;
+}
+
 void
 bb_input_cleanup(struct bb_input *in)
 {
-    if (!in->I) return;
-    for (size_t i = 0; i < in->n; ++i)
-        free(in->I[i].restrictions);
     free(in->I);
+    bb_conflicts_cleanup(&in->conflicts);
+    free(in->pre.orig);
+    free(in->pre.fixed);
 }
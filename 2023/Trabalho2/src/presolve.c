@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bb.h"
+#include "bitset.h"
+#include "conflicts.h"
+
+/** @brief Item kept by the presolve, along with its sorting keys */
+struct _bb_presolve_item {
+    /** index of the item at input */
+    size_t orig;
+    /** amount of conflicting items */
+    size_t degree;
+    /** item weight */
+    unsigned w;
+};
+
+static int
+_bb_presolve_w_cmp(const void *p_a, const void *p_b)
+{
+    const unsigned a = *(const unsigned *)p_a, b = *(const unsigned *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Sort items from the heaviest to the lightest, then by most
+ *      conflicts
+ */
+static int
+_bb_presolve_cmp(const void *p_a, const void *p_b)
+{
+    const struct _bb_presolve_item *a = p_a, *b = p_b;
+
+    if (a->w != b->w) return a->w > b->w ? -1 : 1;
+    if (a->degree != b->degree) return a->degree > b->degree ? -1 : 1;
+    return (a->orig > b->orig) - (a->orig < b->orig);
+}
+
+/**
+ * @brief Whether item `i` can't share a trip with any other item, either
+ *      because no other item fits along with it or because it conflicts
+ *      with every item that does
+ *
+ * @param in data parsed at input
+ * @param i item index
+ * @param sorted_w every item weight, from the lightest to the heaviest
+ * @param nbrs scratch space for the items conflicting with `i`
+ * @return `true` if item `i` needs a trip of its own
+ */
+static bool
+_bb_presolve_is_alone(const struct bb_input *in,
+                      size_t i,
+                      const unsigned sorted_w[],
+                      unsigned nbrs[])
+{
+    const unsigned w = in->I[i].w;
+    size_t lo = 0, hi = in->n, fit, degree;
+
+    /* too heavy even alone, left for the search to report */
+    if (w > in->C) return false;
+
+    /* items that fit along with item i (itself excluded) */
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (sorted_w[mid] <= in->C - w)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    fit = lo - (w <= in->C - w);
+    if (fit == 0) return true;
+
+    degree = bb_conflicts_degree(&in->conflicts, i);
+    if (degree < fit) return false;
+    bb_conflicts_neighbors(&in->conflicts, i, nbrs);
+    for (size_t j = 0, q = 0; j < in->n; ++j) {
+        while (q < degree && nbrs[q] < j)
+            ++q;
+        if (j != i && in->I[j].w <= in->C - w && (q == degree || nbrs[q] != j))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sort items by most conflicts, then from the heaviest to the
+ *      lightest
+ */
+static int
+_bb_presolve_degree_cmp(const void *p_a, const void *p_b)
+{
+    const struct _bb_presolve_item *a = p_a, *b = p_b;
+
+    if (a->degree != b->degree) return a->degree > b->degree ? -1 : 1;
+    if (a->w != b->w) return a->w > b->w ? -1 : 1;
+    return (a->orig > b->orig) - (a->orig < b->orig);
+}
+
+/**
+ * @brief DSatur-style order: repeatedly pick the item with the most
+ *      conflicts among the items already picked, then by most conflicts
+ *      overall, then by weight
+ *
+ * @param in data parsed at input
+ * @param items items to be ordered
+ * @param m amount of items
+ * @param nbrs scratch space for conflicting items
+ * @return a boolean for success
+ */
+static bool
+_bb_presolve_dsatur(const struct bb_input *in,
+                    struct _bb_presolve_item items[],
+                    size_t m,
+                    unsigned nbrs[])
+{
+    size_t *sat = calloc(in->n ? in->n : 1, sizeof *sat);
+
+    if (!sat) {
+        perror("calloc()");
+        return false;
+    }
+    for (size_t pos = 0; pos < m; ++pos) {
+        struct _bb_presolve_item tmp;
+        size_t best = pos, degree;
+
+        for (size_t q = pos + 1; q < m; ++q) {
+            const size_t s_q = sat[items[q].orig],
+                         s_best = sat[items[best].orig];
+
+            if (s_q > s_best
+                || (s_q == s_best
+                    && _bb_presolve_degree_cmp(&items[q], &items[best]) < 0))
+                best = q;
+        }
+        tmp = items[pos];
+        items[pos] = items[best];
+        items[best] = tmp;
+
+        degree = bb_conflicts_neighbors(&in->conflicts, items[pos].orig, nbrs);
+        for (size_t j = 0; j < degree; ++j)
+            ++sat[nbrs[j]];
+    }
+    free(sat);
+    return true;
+}
+
+/**
+ * @brief Keep only the ordered items, renumbering them and their conflicts
+ *
+ * @param in data parsed at input
+ * @param items items kept, in branching order
+ * @param m amount of items kept
+ * @param nbrs scratch space for conflicting items
+ * @return a boolean for success
+ */
+static bool
+_bb_presolve_compact(struct bb_input *in,
+                     const struct _bb_presolve_item items[],
+                     size_t m,
+                     unsigned nbrs[])
+{
+    /* new index of each input item plus one (`0` if fixed) */
+    size_t *new_id = calloc(in->n ? in->n : 1, sizeof *new_id), p = 0,
+           degrees = 0;
+    struct bb_item *I = calloc(m ? m : 1, sizeof *I);
+    struct bb_conflicts conflicts;
+    unsigned *pairs = NULL;
+    bool ok;
+
+    for (size_t i = 0; i < m; ++i)
+        degrees += items[i].degree;
+    if (!new_id || !I || !(pairs = calloc(degrees ? degrees : 1, sizeof *pairs)))
+    {
+        perror("calloc()");
+        free(new_id);
+        free(I);
+        return false;
+    }
+    for (size_t i = 0; i < m; ++i)
+        new_id[items[i].orig] = i + 1;
+
+    for (size_t i = 0; i < m; ++i) {
+        const size_t degree =
+            bb_conflicts_neighbors(&in->conflicts, items[i].orig, nbrs);
+
+        I[i] = in->I[items[i].orig];
+        in->pre.orig[i] = items[i].orig;
+        for (size_t j = 0; j < degree; ++j)
+            if (new_id[nbrs[j]] > i + 1) {
+                pairs[2 * p] = (unsigned)i;
+                pairs[2 * p + 1] = (unsigned)(new_id[nbrs[j]] - 1);
+                ++p;
+            }
+    }
+    ok = bb_conflicts_init(&conflicts, m, pairs, p);
+    free(new_id);
+    free(pairs);
+    if (!ok) {
+        bb_conflicts_cleanup(&conflicts);
+        free(I);
+        return false;
+    }
+
+    free(in->I);
+    bb_conflicts_cleanup(&in->conflicts);
+    in->I = I;
+    in->conflicts = conflicts;
+    in->n = m;
+    in->p = p;
+    in->words_I = BB_BITSET_WORDS(m);
+    return true;
+}
+
+bool
+bb_presolve(struct bb_input *in, enum bb_presolve_order order)
+{
+    struct _bb_presolve_item *items = calloc(in->n ? in->n : 1, sizeof *items);
+    unsigned *sorted_w = calloc(in->n ? in->n : 1, sizeof *sorted_w),
+             *nbrs = calloc(in->n ? in->n : 1, sizeof *nbrs);
+    size_t m = 0;
+    bool ok = false;
+
+    in->pre.n = in->n;
+    in->pre.orig = calloc(in->n ? in->n : 1, sizeof *in->pre.orig);
+    in->pre.fixed = calloc(in->n ? in->n : 1, sizeof *in->pre.fixed);
+    if (!items || !sorted_w || !nbrs || !in->pre.orig || !in->pre.fixed) {
+        perror("calloc()");
+        goto _cleanup;
+    }
+    for (size_t i = 0; i < in->n; ++i)
+        sorted_w[i] = in->I[i].w;
+    qsort(sorted_w, in->n, sizeof *sorted_w, &_bb_presolve_w_cmp);
+
+    /* an item that can't share a trip with any other gets one for good */
+    for (size_t i = 0; i < in->n; ++i) {
+        if (_bb_presolve_is_alone(in, i, sorted_w, nbrs))
+            in->pre.fixed[in->pre.fixed_m++] = i;
+        else
+            items[m++] = (struct _bb_presolve_item){
+                .orig = i,
+                .degree = bb_conflicts_degree(&in->conflicts, i),
+                .w = in->I[i].w,
+            };
+    }
+
+    if (order == BB_PRESOLVE_DSATUR) {
+        if (!_bb_presolve_dsatur(in, items, m, nbrs)) goto _cleanup;
+    }
+    else {
+        qsort(items, m, sizeof *items, &_bb_presolve_cmp);
+    }
+    ok = _bb_presolve_compact(in, items, m, nbrs);
+
+_cleanup:
+    free(items);
+    free(sorted_w);
+    free(nbrs);
+    return ok;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "scan.h"
+
+/** @brief Whether `c` separates tokens */
+#define IS_SPACE(c)                                                           \
+    ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\r' || (c) == '\v'  \
+     || (c) == '\f')
+
+/**
+ * @brief Read more of the input, keeping the bytes not yet tokenized
+ * @note a no-op for mapped files, whose bytes are all available
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @return a boolean for success
+ */
+static bool
+_bb_scan_fill(struct bb_scan *sc)
+{
+    const size_t left = (size_t)(sc->end - sc->cur);
+    ssize_t nread;
+
+    if (sc->eof) return true;
+    memmove(sc->buf, sc->cur, left);
+    sc->cur = sc->buf;
+    sc->end = sc->buf + left;
+    do {
+        nread = read(sc->fd, sc->buf + left, sc->buf_size - left);
+    } while (nread < 0 && errno == EINTR);
+    if (nread < 0) {
+        perror("read()");
+        return false;
+    }
+    if (nread == 0)
+        sc->eof = true;
+    else
+        sc->end += nread;
+    return true;
+}
+
+/**
+ * @brief Skip whitespace, then make sure a whole token is available
+ *
+ * @param sc scanner initialized with bb_scan_open()
+ * @return `true` if a token starts at `sc->cur`
+ */
+static bool
+_bb_scan_token(struct bb_scan *sc)
+{
+    while (1) {
+        while (sc->cur < sc->end && IS_SPACE(*sc->cur))
+            ++sc->cur;
+        if (sc->cur < sc->end) break;
+        if (sc->eof || !_bb_scan_fill(sc)) return false;
+    }
+    /* a token longer than BB_SCAN_TOKEN_MAX is rejected anyway */
+    while (!sc->eof && sc->end - sc->cur < BB_SCAN_TOKEN_MAX)
+        if (!_bb_scan_fill(sc)) return false;
+    return true;
+}
+
+bool
+bb_scan_open(struct bb_scan *sc, const char *path)
+{
+    struct stat st;
+
+    *sc = (struct bb_scan){ .fd = STDIN_FILENO };
+    if (path) {
+        if ((sc->fd = open(path, O_RDONLY)) < 0) {
+            perror(path);
+            return false;
+        }
+        sc->owns_fd = true;
+    }
+
+    if (fstat(sc->fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                         sc->fd, 0);
+
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            sc->map = map;
+            sc->map_size = (size_t)st.st_size;
+            sc->cur = map;
+            sc->end = sc->cur + sc->map_size;
+            sc->eof = true;
+            return true;
+        }
+    }
+
+    /* not a regular file (or it couldn't be mapped), read it in chunks */
+    if (!(sc->buf = malloc(BB_SCAN_CHUNK))) {
+        perror("malloc()");
+        return false;
+    }
+    sc->buf_size = BB_SCAN_CHUNK;
+    sc->cur = sc->end = sc->buf;
+    return true;
+}
+
+bool
+bb_scan_ulong(struct bb_scan *sc, unsigned long max, unsigned long *value)
+{
+    unsigned long v = 0;
+
+    if (!_bb_scan_token(sc)) return false;
+    if (*sc->cur < '0' || *sc->cur > '9') return false;
+    for (; sc->cur < sc->end && *sc->cur >= '0' && *sc->cur <= '9'; ++sc->cur)
+    {
+        const unsigned digit = (unsigned)(*sc->cur - '0');
+
+        if (digit > max || v > (max - digit) / 10) return false;
+        v = v * 10 + digit;
+    }
+    /* the token must end at whitespace or at the end of the input */
+    if (sc->cur < sc->end ? !IS_SPACE(*sc->cur) : !sc->eof) return false;
+
+    *value = v;
+    return true;
+}
+
+bool
+bb_scan_peek(struct bb_scan *sc, const void *prefix, size_t size)
+{
+    while (!sc->eof && (size_t)(sc->end - sc->cur) < size)
+        if (!_bb_scan_fill(sc)) return false;
+    return (size_t)(sc->end - sc->cur) >= size
+           && memcmp(sc->cur, prefix, size) == 0;
+}
+
+const void *
+bb_scan_rest(struct bb_scan *sc, size_t *size)
+{
+    const char *rest;
+
+    while (!sc->eof) {
+        /* keep a chunk of free room at the end of the buffer */
+        if (sc->buf_size - (size_t)(sc->end - sc->buf) < BB_SCAN_CHUNK) {
+            const size_t cur = (size_t)(sc->cur - sc->buf),
+                         end = (size_t)(sc->end - sc->buf);
+            char *tmp = realloc(sc->buf, 2 * sc->buf_size);
+
+            if (!tmp) {
+                perror("realloc()");
+                return NULL;
+            }
+            sc->buf = tmp;
+            sc->buf_size *= 2;
+            sc->cur = tmp + cur;
+            sc->end = tmp + end;
+        }
+        if (!_bb_scan_fill(sc)) return NULL;
+    }
+    rest = sc->cur;
+    *size = (size_t)(sc->end - sc->cur);
+    sc->cur = sc->end;
+    return rest;
+}
+
+bool
+bb_scan_at_end(struct bb_scan *sc)
+{
+    return !_bb_scan_token(sc) && sc->eof;
+}
+
+void
+bb_scan_close(struct bb_scan *sc)
+{
+    if (sc->map) munmap(sc->map, sc->map_size);
+    free(sc->buf);
+    if (sc->owns_fd) close(sc->fd);
+}